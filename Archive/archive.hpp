@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../Array/array.hpp"
+#include "../Deque/deque.hpp"
+#include "../String/str.hpp"
+#include "../Vector/vector.hpp"
+
+// Binary archives for the containers of this repo. An archive starts with a header
+// of a magic number and a format version; everything after it is written in the byte
+// order and type sizes of the machine, so archives are meant to be read back on the
+// same kind of machine, not exchanged between different ones.
+//
+// Containers of trivially copyable elements are written with one call per contiguous
+// block of memory: one for a Vector, String or Array, one per chunk for a Deque.
+// Other elements are written one by one with their own Save.
+//
+// To make a type of your own archivable, declare Save(OutputArchive&, const X&) and
+// Load(InputArchive&, X&) next to it.
+//
+// Loads never allocate for more elements than the rest of the stream can hold, so a
+// corrupt count fails with "Archive is truncated" instead of allocating what it says.
+// A stream that can't seek is read in batches of kLoadBatchBytes instead.
+
+static constexpr uint32_t kArchiveMagic = 0x52415344;  // "DSAR" in little endian
+static constexpr uint32_t kArchiveVersion = 1;
+static constexpr size_t kLoadBatchBytes = size_t(1) << 20;
+
+class OutputArchive {
+public:
+    explicit OutputArchive(std::ostream& out) : out_(out) {
+        Write(kArchiveMagic);
+        Write(kArchiveVersion);
+    }
+
+    void WriteBytes(const void* data, size_t bytes) {
+        if (bytes == 0)
+            return;
+
+        out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        if (!out_)
+            throw std::runtime_error("Archive write failed");
+    }
+
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values are written as bytes");
+        WriteBytes(&value, sizeof(T));
+    }
+
+private:
+    std::ostream& out_;
+};
+
+class InputArchive {
+public:
+    static constexpr size_t kUnknownBytes = static_cast<size_t>(-1);
+
+    // Throws std::runtime_error if the stream doesn't start with a header of this version
+    explicit InputArchive(std::istream& in) : in_(in) {
+        std::streampos start = in_.tellg();
+        if (start != std::streampos(-1)) {
+            in_.seekg(0, std::ios::end);
+            std::streampos end = in_.tellg();
+            in_.clear();
+            in_.seekg(start);
+            if (in_ && end != std::streampos(-1) && end >= start)
+                bytes_left_ = static_cast<size_t>(end - start);
+        }
+
+        if (Read<uint32_t>() != kArchiveMagic)
+            throw std::runtime_error("Not an archive, or written with another byte order");
+
+        version_ = Read<uint32_t>();
+        if (version_ != kArchiveVersion)
+            throw std::runtime_error("Unsupported archive version");
+    }
+
+    uint32_t Version() const {
+        return version_;
+    }
+
+    // Bytes between the read position and the end of the stream, or kUnknownBytes
+    // if the stream can't seek
+    size_t BytesLeft() const {
+        return bytes_left_;
+    }
+
+    void ReadBytes(void* data, size_t bytes) {
+        if (bytes == 0)
+            return;
+
+        in_.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+        if (!in_)
+            throw std::runtime_error("Archive is truncated");
+        if (bytes_left_ != kUnknownBytes)
+            bytes_left_ -= std::min(bytes, bytes_left_);
+    }
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values are read as bytes");
+        T value;
+        ReadBytes(&value, sizeof(T));
+        return value;
+    }
+
+private:
+    std::istream& in_;
+    uint32_t version_ = 0;
+    size_t bytes_left_ = kUnknownBytes;
+};
+
+
+//-----------------------------trivially copyable--------------------------------
+
+template <typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+void Save(OutputArchive& archive, const T& value) {
+    archive.Write(value);
+}
+
+template <typename T, typename = std::enable_if_t<std::is_trivially_copyable_v<T>>>
+void Load(InputArchive& archive, T& value) {
+    archive.ReadBytes(&value, sizeof(T));
+}
+
+
+//-----------------------------block headers--------------------------------
+
+// Every container starts with its size and the size of its elements, or 0 for
+// elements saved one by one. The element size catches loading into another type.
+template <typename T>
+void SaveBlockHeader(OutputArchive& archive, size_t count) {
+    archive.Write(static_cast<uint64_t>(count));
+    archive.Write(static_cast<uint32_t>(std::is_trivially_copyable_v<T> ? sizeof(T) : 0));
+}
+
+template <typename T>
+size_t LoadBlockHeader(InputArchive& archive) {
+    uint64_t count = archive.Read<uint64_t>();
+    if (archive.Read<uint32_t>() != (std::is_trivially_copyable_v<T> ? sizeof(T) : 0))
+        throw std::runtime_error("Archived elements are of another type");
+    return static_cast<size_t>(count);
+}
+
+// How many of the next count elements, each at least min_bytes in the archive, a loader
+// may allocate before it reads them: as many as the rest of the stream can hold, but at
+// least one, so that reading it reports a truncated archive
+inline size_t LoadableCount(const InputArchive& archive, size_t count, size_t min_bytes) {
+    size_t bytes = archive.BytesLeft() == InputArchive::kUnknownBytes ? kLoadBatchBytes : archive.BytesLeft();
+    return std::min(count, std::max(bytes / min_bytes, size_t(1)));
+}
+
+
+//-----------------------------String--------------------------------
+
+inline void Save(OutputArchive& archive, const String& str) {
+    SaveBlockHeader<char>(archive, str.Size());
+    archive.WriteBytes(str.Data(), str.Size());
+}
+
+inline void Load(InputArchive& archive, String& str) {
+    size_t size = LoadBlockHeader<char>(archive);
+    String loaded;
+    while (loaded.Size() < size) {
+        size_t done = loaded.Size();
+        size_t count = LoadableCount(archive, size - done, 1);
+        if (done + count > loaded.Capacity())
+            loaded.Reserve(std::max(done + count, 2 * loaded.Capacity()));
+        loaded.Resize(done + count, '\0');
+        archive.ReadBytes(&loaded[done], count);
+    }
+    str.Swap(loaded);
+}
+
+
+//-----------------------------Array--------------------------------
+
+template <typename T, int N>
+void Save(OutputArchive& archive, const Array<T, N>& arr) {
+    SaveBlockHeader<T>(archive, N);
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        archive.WriteBytes(arr.Data(), sizeof(T) * N);
+    } else {
+        for (int i = 0; i < N; ++i)
+            Save(archive, arr[i]);
+    }
+}
+
+template <typename T, int N>
+void Load(InputArchive& archive, Array<T, N>& arr) {
+    if (LoadBlockHeader<T>(archive) != N)
+        throw std::runtime_error("Archived array is of another size");
+
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        archive.ReadBytes(arr.Data(), sizeof(T) * N);
+    } else {
+        for (int i = 0; i < N; ++i)
+            Load(archive, arr[i]);
+    }
+}
+
+
+//-----------------------------Vector--------------------------------
+
+template <typename T, typename Alloc, typename Growth>
+void Save(OutputArchive& archive, const Vector<T, Alloc, Growth>& vec) {
+    SaveBlockHeader<T>(archive, vec.Size());
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        archive.WriteBytes(vec.Data(), sizeof(T) * vec.Size());
+    } else {
+        for (const T& elem : vec)
+            Save(archive, elem);
+    }
+}
+
+// On failure vec is left as it was
+template <typename T, typename Alloc, typename Growth>
+void Load(InputArchive& archive, Vector<T, Alloc, Growth>& vec) {
+    size_t size = LoadBlockHeader<T>(archive);
+    Vector<T, Alloc, Growth> loaded(vec.GetAllocator());
+
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        // One batch unless the count is more than the stream holds or it can't seek
+        while (loaded.Size() < size) {
+            size_t done = loaded.Size();
+            size_t count = LoadableCount(archive, size - done, sizeof(T));
+            if (done + count > loaded.Capacity())
+                loaded.Reserve(std::max(done + count, 2 * loaded.Capacity()));
+            if constexpr (std::is_trivially_default_constructible_v<T>) {
+                loaded.ResizeUninitialized(done + count);
+            } else {
+                loaded.Resize(done + count);
+            }
+            archive.ReadBytes(loaded.Data() + done, sizeof(T) * count);
+        }
+    } else {
+        // Elements may take any number of bytes, the count only bounds the first allocation
+        loaded.Reserve(LoadableCount(archive, size, 1));
+        for (size_t i = 0; i < size; ++i) {
+            T elem;
+            Load(archive, elem);
+            loaded.PushBack(std::move(elem));
+        }
+    }
+    vec.Swap(loaded);
+}
+
+
+//-----------------------------Deque--------------------------------
+
+template <typename T, typename Alloc, typename ChunkGeometry>
+void Save(OutputArchive& archive, const Deque<T, Alloc, ChunkGeometry>& deque) {
+    SaveBlockHeader<T>(archive, deque.size());
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        deque.for_each_segment([&archive](const T* data, size_t count) {
+            archive.WriteBytes(data, sizeof(T) * count);
+        });
+    } else {
+        for (const T& elem : deque)
+            Save(archive, elem);
+    }
+}
+
+// On failure deque is left as it was
+template <typename T, typename Alloc, typename ChunkGeometry>
+void Load(InputArchive& archive, Deque<T, Alloc, ChunkGeometry>& deque) {
+    size_t size = LoadBlockHeader<T>(archive);
+    Deque<T, Alloc, ChunkGeometry> loaded(deque.get_allocator());
+
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        // Read a page or so at a time, the deque grows with what was actually read
+        Vector<T> batch(std::min(size, std::max(size_t(4096) / sizeof(T), size_t(1))));
+        while (loaded.size() < size) {
+            size_t count = std::min(size - loaded.size(), batch.Size());
+            archive.ReadBytes(batch.Data(), sizeof(T) * count);
+            for (size_t i = 0; i < count; ++i)
+                loaded.emplace_back(batch[i]);
+        }
+    } else {
+        for (size_t i = 0; i < size; ++i) {
+            loaded.emplace_back();
+            Load(archive, loaded.back());
+        }
+    }
+    deque.swap(loaded);
+}
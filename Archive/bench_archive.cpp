@@ -0,0 +1,166 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <cassert>
+
+#include "archive.hpp"
+
+const std::string kPath = "/tmp/bench_archive";
+
+// Best of a few runs, the first one also pays for the page cache
+template <typename Func>
+long long MeasureMs(Func&& func, int runs = 3) {
+    using namespace std::chrono;
+
+    long long best = -1;
+    for (int i = 0; i < runs; ++i) {
+        auto start = high_resolution_clock::now();
+        func();
+        auto finish = high_resolution_clock::now();
+        long long elapsed = duration_cast<milliseconds>(finish - start).count();
+        if (best < 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+// The text path: the size, then the elements separated by spaces
+template <typename Container, typename WriteElements>
+void SaveText(const Container& container, size_t size, WriteElements&& write) {
+    std::ofstream out(kPath);
+    out << size << ' ';
+    write(out, container);
+}
+
+template <typename T>
+void SaveArchive(const T& value) {
+    std::ofstream out(kPath, std::ios::binary);
+    OutputArchive archive(out);
+    Save(archive, value);
+}
+
+template <typename T>
+void LoadArchive(T& value) {
+    std::ifstream in(kPath, std::ios::binary);
+    InputArchive archive(in);
+    Load(archive, value);
+}
+
+void PrintRow(const char* name, long long save_ms, long long load_ms) {
+    std::cerr << "  " << name << ": save " << save_ms << " ms, load " << load_ms << " ms" << std::endl;
+}
+
+void BenchmarkVector(size_t count) {
+    Vector<int> v;
+    for (size_t i = 0; i < count; ++i) {
+        v.PushBack(static_cast<int>(i * 7919));
+    }
+
+    std::cerr << "Vector<int> of " << count << " elements:" << std::endl;
+    long long save_ms = MeasureMs([&v] {
+        SaveText(v, v.Size(), [](std::ostream& out, const Vector<int>& vec) {
+            for (int elem : vec)
+                out << elem << ' ';
+        });
+    });
+    long long load_ms = MeasureMs([&v] {
+        std::ifstream in(kPath);
+        size_t size = 0;
+        in >> size;
+        Vector<int> loaded;
+        loaded.Reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            int elem = 0;
+            in >> elem;
+            loaded.PushBack(elem);
+        }
+        assert(loaded.Size() == v.Size());
+    });
+    PrintRow("stream ", save_ms, load_ms);
+
+    save_ms = MeasureMs([&v] { SaveArchive(v); });
+    load_ms = MeasureMs([&v] {
+        Vector<int> loaded;
+        LoadArchive(loaded);
+        assert(loaded.Size() == v.Size());
+    });
+    PrintRow("archive", save_ms, load_ms);
+}
+
+void BenchmarkString(size_t size) {
+    String str(size, 'a');
+    for (size_t i = 0; i < size; i += 61) {
+        str[i] = '\n';
+    }
+
+    std::cerr << "String of " << size << " characters:" << std::endl;
+    long long save_ms = MeasureMs([&str] {
+        SaveText(str, str.Size(), [](std::ostream& out, const String& s) { out << s; });
+    });
+    long long load_ms = MeasureMs([&str] {
+        std::ifstream in(kPath);
+        size_t size = 0;
+        in >> size;
+        in.get();
+        String loaded;
+        loaded.Reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            loaded.PushBack(static_cast<char>(in.get()));
+        }
+        assert(loaded == str);
+    });
+    PrintRow("stream ", save_ms, load_ms);
+
+    save_ms = MeasureMs([&str] { SaveArchive(str); });
+    load_ms = MeasureMs([&str] {
+        String loaded;
+        LoadArchive(loaded);
+        assert(loaded == str);
+    });
+    PrintRow("archive", save_ms, load_ms);
+}
+
+void BenchmarkDeque(size_t count) {
+    Deque<int> deque;
+    for (size_t i = 0; i < count; ++i) {
+        deque.push_back(static_cast<int>(i * 7919));
+    }
+
+    std::cerr << "Deque<int> of " << count << " elements:" << std::endl;
+    long long save_ms = MeasureMs([&deque] {
+        SaveText(deque, deque.size(), [](std::ostream& out, const Deque<int>& d) {
+            for (int elem : d)
+                out << elem << ' ';
+        });
+    });
+    long long load_ms = MeasureMs([&deque] {
+        std::ifstream in(kPath);
+        size_t size = 0;
+        in >> size;
+        Deque<int> loaded;
+        for (size_t i = 0; i < size; ++i) {
+            int elem = 0;
+            in >> elem;
+            loaded.push_back(elem);
+        }
+        assert(loaded.size() == deque.size());
+    });
+    PrintRow("stream ", save_ms, load_ms);
+
+    save_ms = MeasureMs([&deque] { SaveArchive(deque); });
+    load_ms = MeasureMs([&deque] {
+        Deque<int> loaded;
+        LoadArchive(loaded);
+        assert(loaded.size() == deque.size());
+    });
+    PrintRow("archive", save_ms, load_ms);
+}
+
+int main() {
+    BenchmarkVector(10'000'000);
+    BenchmarkString(50'000'000);
+    BenchmarkDeque(10'000'000);
+    std::remove(kPath.c_str());
+}
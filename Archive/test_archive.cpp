@@ -0,0 +1,205 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "archive.hpp"
+
+struct Point {
+  int32_t x;
+  int32_t y;
+};
+
+template <typename T>
+std::string SaveToString(const T& value) {
+  std::ostringstream out;
+  OutputArchive archive(out);
+  Save(archive, value);
+  return out.str();
+}
+
+template <typename T>
+void LoadFromString(const std::string& bytes, T& value) {
+  std::istringstream in(bytes);
+  InputArchive archive(in);
+  Load(archive, value);
+}
+
+// Overwrites the count of the first container in an archive
+std::string WithCount(std::string bytes, uint64_t count) {
+  std::memcpy(&bytes[8], &count, sizeof(count));
+  return bytes;
+}
+
+// Reads a string the way a pipe does, without seeking
+struct OneWayBuffer : std::streambuf {
+  explicit OneWayBuffer(std::string& bytes) {
+    setg(bytes.data(), bytes.data(), bytes.data() + bytes.size());
+  }
+};
+
+TEST_CASE("Vector round trip") {
+  Vector<Point> points;
+  for (int i = 0; i < 1000; ++i) {
+    points.PushBack({i, -i});
+  }
+  std::string bytes = SaveToString(points);
+  // Header, size, element size and the elements themselves
+  REQUIRE(bytes.size() == 8 + 12 + 1000 * sizeof(Point));
+
+  Vector<Point> loaded(3, Point{7, 7});
+  LoadFromString(bytes, loaded);
+  REQUIRE(loaded.Size() == 1000u);
+  REQUIRE(loaded[999].x == 999);
+  REQUIRE(loaded[999].y == -999);
+
+  LoadFromString(SaveToString(Vector<Point>()), loaded);
+  REQUIRE(loaded.Empty());
+}
+
+TEST_CASE("Vector of non-trivial elements") {
+  Vector<String> words;
+  words.PushBack("binary");
+  words.PushBack("");
+  words.PushBack("archive");
+
+  Vector<String> loaded;
+  LoadFromString(SaveToString(words), loaded);
+  REQUIRE(loaded.Size() == 3u);
+  REQUIRE(loaded[0] == String("binary"));
+  REQUIRE(loaded[1].Empty());
+  REQUIRE(loaded[2] == String("archive"));
+
+  Vector<Vector<int>> nested(3, Vector<int>(5, 42));
+  Vector<Vector<int>> nested_loaded;
+  LoadFromString(SaveToString(nested), nested_loaded);
+  REQUIRE(nested_loaded.Size() == 3u);
+  REQUIRE(nested_loaded[2].Size() == 5u);
+  REQUIRE(nested_loaded[2][4] == 42);
+}
+
+TEST_CASE("String and Array round trip") {
+  String str("Hello, archive!");
+  String loaded("to be replaced");
+  LoadFromString(SaveToString(str), loaded);
+  REQUIRE(loaded == str);
+  REQUIRE(loaded.Size() == str.Size());
+
+  Array<double, 4> arr = {1.5, 2.5, 3.5, 4.5};
+  Array<double, 4> arr_loaded;
+  LoadFromString(SaveToString(arr), arr_loaded);
+  REQUIRE(arr_loaded[0] == 1.5);
+  REQUIRE(arr_loaded[3] == 4.5);
+
+  Array<String, 2> strings = {String("a"), String("bc")};
+  Array<String, 2> strings_loaded;
+  LoadFromString(SaveToString(strings), strings_loaded);
+  REQUIRE(strings_loaded[1] == String("bc"));
+
+  Array<double, 3> wrong_size;
+  REQUIRE_THROWS_AS(LoadFromString(SaveToString(arr), wrong_size), std::runtime_error);
+}
+
+TEST_CASE("Deque round trip") {
+  Deque<int64_t> deque;
+  for (int i = 0; i < 1000; ++i) {
+    deque.push_back(i);
+    deque.push_front(-i);
+  }
+
+  Deque<int64_t> loaded = {1, 2, 3};
+  LoadFromString(SaveToString(deque), loaded);
+  REQUIRE(loaded == deque);
+
+  size_t segments = 0;
+  size_t elements = 0;
+  loaded.for_each_segment([&segments, &elements](int64_t* data, size_t count) {
+    REQUIRE(data != nullptr);
+    ++segments;
+    elements += count;
+  });
+  REQUIRE(segments > 1);
+  REQUIRE(elements == 2000u);
+
+  Deque<String> words = {String("front"), String("back")};
+  Deque<String> words_loaded;
+  LoadFromString(SaveToString(words), words_loaded);
+  REQUIRE(words_loaded == words);
+}
+
+TEST_CASE("Bad archives") {
+  Vector<int> v;
+  REQUIRE_THROWS_AS(LoadFromString("", v), std::runtime_error);
+  REQUIRE_THROWS_AS(LoadFromString("not an archive", v), std::runtime_error);
+
+  std::string bytes = SaveToString(Vector<int>(100, 1));
+  std::string newer = bytes;
+  newer[4] = 2;
+  REQUIRE_THROWS_AS(LoadFromString(newer, v), std::runtime_error);
+
+  v.PushBack(5);
+  REQUIRE_THROWS_AS(LoadFromString(bytes.substr(0, bytes.size() - 1), v), std::runtime_error);
+  REQUIRE(v.Size() == 1u);
+  REQUIRE(v[0] == 5);
+
+  Vector<int64_t> wrong_type;
+  REQUIRE_THROWS_AS(LoadFromString(bytes, wrong_type), std::runtime_error);
+}
+
+TEST_CASE("Corrupt counts") {
+  const uint64_t kHuge = uint64_t(1) << 60;
+
+  std::string bytes = SaveToString(Vector<int>(4, 1));
+  std::istringstream in(bytes);
+  InputArchive archive(in);
+  REQUIRE(archive.BytesLeft() == bytes.size() - 8);
+
+  Vector<int> v(1, 5);
+  REQUIRE_THROWS_AS(LoadFromString(WithCount(bytes, kHuge), v), std::runtime_error);
+  REQUIRE(v.Size() == 1u);
+
+  Vector<String> words(1, String("kept"));
+  REQUIRE_THROWS_AS(LoadFromString(WithCount(SaveToString(Vector<String>(2, String("a"))), kHuge), words),
+                    std::runtime_error);
+  REQUIRE(words[0] == String("kept"));
+
+  String str("kept");
+  REQUIRE_THROWS_AS(LoadFromString(WithCount(SaveToString(String("four")), kHuge), str), std::runtime_error);
+  REQUIRE(str == String("kept"));
+
+  Deque<int64_t> deque = {1, 2};
+  REQUIRE_THROWS_AS(LoadFromString(WithCount(SaveToString(deque), kHuge), deque), std::runtime_error);
+  REQUIRE(deque == Deque<int64_t>{1, 2});
+
+  Deque<String> words_deque = {String("kept")};
+  REQUIRE_THROWS_AS(LoadFromString(WithCount(SaveToString(words_deque), kHuge), words_deque), std::runtime_error);
+  REQUIRE(words_deque.size() == 1u);
+}
+
+TEST_CASE("Streams that can't seek") {
+  // Several batches of kLoadBatchBytes
+  Vector<int> values;
+  for (int i = 0; i < 1'000'000; ++i) {
+    values.PushBack(i);
+  }
+  std::string bytes = SaveToString(values);
+
+  OneWayBuffer buffer(bytes);
+  std::istream in(&buffer);
+  InputArchive archive(in);
+  REQUIRE(archive.BytesLeft() == InputArchive::kUnknownBytes);
+  Vector<int> loaded;
+  Load(archive, loaded);
+  REQUIRE(loaded.Size() == values.Size());
+  REQUIRE(loaded[999'999] == 999'999);
+
+  std::string corrupt = WithCount(bytes, uint64_t(1) << 60);
+  OneWayBuffer corrupt_buffer(corrupt);
+  std::istream corrupt_in(&corrupt_buffer);
+  InputArchive corrupt_archive(corrupt_in);
+  REQUIRE_THROWS_AS(Load(corrupt_archive, loaded), std::runtime_error);
+  REQUIRE(loaded.Size() == values.Size());
+}
@@ -0,0 +1,404 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "deque.hpp"
+#include "deque_algorithms.hpp"
+#include "work_stealing_deque.hpp"
+#include "../Vector/vector.hpp"
+
+// Best of a few runs
+template <typename Func>
+long long MeasureMs(Func&& func, int runs = 3) {
+    using namespace std::chrono;
+
+    long long best = -1;
+    for (int i = 0; i < runs; ++i) {
+        auto start = high_resolution_clock::now();
+        func();
+        auto finish = high_resolution_clock::now();
+        long long elapsed = duration_cast<milliseconds>(finish - start).count();
+        if (best < 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+long CurrentRssMb() {
+    long pages = 0;
+    long resident = 0;
+    FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr)
+        return -1;
+    if (std::fscanf(statm, "%ld %ld", &pages, &resident) != 2)
+        resident = -1;
+    std::fclose(statm);
+    return resident * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
+// Keeps the optimizer from dropping the loops
+volatile long long sink = 0;
+
+// Runs func in a child process, so that every queue starts from the same heap
+template <typename Func>
+void InChild(Func&& func) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        func();
+        _exit(0);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+// A queue that fills up to kDepth and drains again, over and over, with the RSS
+// after every round
+template <typename Queue>
+void FifoTest(const char* name) {
+    const size_t kDepth = 1'000'000;
+    const int kRounds = 8;
+
+    InChild([name] {
+        using namespace std::chrono;
+
+        Queue queue;
+        long long sum = 0;
+        auto start = high_resolution_clock::now();
+        std::cerr << "  " << name << "RSS MB per round:";
+        for (int round = 0; round < kRounds; ++round) {
+            for (size_t i = 0; i < kDepth; ++i) {
+                queue.push_back(static_cast<long long>(i));
+                queue.push_back(static_cast<long long>(i));
+                sum += queue.front();
+                queue.pop_front();
+            }
+            while (!queue.empty()) {
+                sum += queue.front();
+                queue.pop_front();
+            }
+            std::cerr << " " << CurrentRssMb();
+        }
+        auto total = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        sink = sum;
+        std::cerr << ", " << total << " ms" << std::endl;
+    });
+}
+
+void BenchmarkFifo() {
+    std::cerr << "FIFO queue of long long, filled to 1M and drained 8 times:" << std::endl;
+    FifoTest<Deque<long long>>("Deque:      ");
+    FifoTest<std::deque<long long>>("std::deque: ");
+}
+
+// Strings too long for the small string buffer, so copies allocate
+template <typename Queue>
+void StringTest(const char* name, size_t count) {
+    std::string prefix(40, 'x');
+    Queue source;
+    for (size_t i = 0; i < count; ++i)
+        source.push_back(prefix + std::to_string(i));
+
+    long long push_moved = MeasureMs([&] {
+        Queue queue;
+        Queue copy = source;
+        for (auto& str : copy)
+            queue.push_back(std::move(str));
+        sink = static_cast<long long>(queue.size());
+    });
+    long long assign = MeasureMs([&] {
+        Queue queue;
+        for (int i = 0; i < 10; ++i) {
+            Queue copy = source;
+            queue = std::move(copy);
+        }
+        sink = static_cast<long long>(queue.size());
+    });
+    long long erase = MeasureMs([&] {
+        Queue queue = source;
+        for (int i = 0; i < 20; ++i)
+            queue.erase(queue.begin() + static_cast<std::ptrdiff_t>(queue.size() / 2));
+        sink = static_cast<long long>(queue.size());
+    });
+    std::cerr << "  " << name << "copy + move all " << push_moved << " ms, 10 copy + move-assign " << assign
+              << " ms, 20 middle erases " << erase << " ms" << std::endl;
+}
+
+void BenchmarkStrings() {
+    const size_t kCount = 1'000'000;
+
+    std::cerr << "Deque of " << kCount << " strings:" << std::endl;
+    StringTest<Deque<std::string>>("Deque:      ", kCount);
+    StringTest<std::deque<std::string>>("std::deque: ", kCount);
+}
+
+struct Big {
+    long long value;
+    char payload[248];
+
+    Big(long long value = 0) : value(value) {}
+
+    explicit operator long long() const {
+        return value;
+    }
+};
+
+template <typename Queue>
+void GeometryTest(const char* name, size_t count) {
+    using T = typename Queue::value_type;
+
+    Queue queue;
+    for (size_t i = 0; i < count; ++i)
+        queue.push_back(T(static_cast<char>(i)));
+
+    auto value = [](const T& elem) { return static_cast<long long>(elem); };
+    long long indexed = MeasureMs([&] {
+        long long sum = 0;
+        for (size_t i = 0; i < queue.size(); ++i)
+            sum += value(queue[i]);
+        sink = sum;
+    });
+    long long random = MeasureMs([&] {
+        long long sum = 0;
+        size_t idx = 0;
+        for (size_t i = 0; i < count; ++i) {
+            idx = (idx * 6'364'136'223'846'793'005ull + 1'442'695'040'888'963'407ull);
+            sum += value(queue[(idx >> 33) % count]);
+        }
+        sink = sum;
+    });
+    long long iterated = MeasureMs([&] {
+        long long sum = 0;
+        for (const T& elem : queue)
+            sum += value(elem);
+        sink = sum;
+    });
+    std::cerr << "  " << name << "operator[] " << indexed << " ms, random operator[] " << random << " ms, iteration "
+              << iterated << " ms" << std::endl;
+}
+
+void BenchmarkGeometry() {
+    const size_t kSmallCount = 64'000'000;
+    const size_t kBigCount = 500'000;
+
+    std::cerr << "Deque<char> of " << kSmallCount << " elements:" << std::endl;
+    GeometryTest<Deque<char>>("Deque, 4096 bytes:     ", kSmallCount);
+    GeometryTest<Deque<char, std::allocator<char>, FixedChunks<128>>>("Deque, 128 elements:   ", kSmallCount);
+    GeometryTest<std::deque<char>>("std::deque:            ", kSmallCount);
+
+    std::cerr << "Deque of " << kBigCount << " 256-byte structs:" << std::endl;
+    GeometryTest<Deque<Big>>("Deque, 4096 bytes:     ", kBigCount);
+    GeometryTest<Deque<Big, std::allocator<Big>, FixedChunks<128>>>("Deque, 128 elements:   ", kBigCount);
+    GeometryTest<std::deque<Big>>("std::deque:            ", kBigCount);
+}
+
+template <typename Queue>
+void MiddleInsertTest(const char* name) {
+    const int kInserts = 50'000;
+
+    // Positions at a fixed fraction of the size, closer to the front or to the middle
+    auto single = [](double fraction) {
+        return MeasureMs([fraction] {
+            Queue queue;
+            for (int i = 0; i < kInserts; ++i) {
+                auto pos = static_cast<std::ptrdiff_t>(static_cast<double>(queue.size()) * fraction);
+                queue.insert(queue.begin() + pos, i);
+            }
+            sink = queue[queue.size() / 2];
+        }, 1);
+    };
+    long long tenth = single(0.1);
+    long long middle = single(0.5);
+
+    long long ranges = MeasureMs([] {
+        Queue queue(100'000, 1);
+        std::vector<int> values(1000, 2);
+        for (int i = 0; i < 500; ++i) {
+            auto pos = static_cast<std::ptrdiff_t>(queue.size() / 3);
+            queue.insert(queue.begin() + pos, values.begin(), values.end());
+            queue.erase(queue.begin() + pos / 2, queue.begin() + pos / 2 + 500);
+        }
+        sink = static_cast<long long>(queue.size());
+    });
+    std::cerr << "  " << name << kInserts << " inserts at 1/10: " << tenth << " ms, at 1/2: " << middle
+              << " ms, 500 x (insert 1000 + erase 500) at 1/3: " << ranges << " ms" << std::endl;
+}
+
+void BenchmarkMiddleInsert() {
+    std::cerr << "Inserts into the middle of a deque of int:" << std::endl;
+    MiddleInsertTest<Deque<int>>("Deque:      ");
+    MiddleInsertTest<std::deque<int>>("std::deque: ");
+}
+
+// The same interface as WorkStealingDeque behind one mutex
+template <typename T>
+class LockedDeque {
+public:
+    void push(T value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        deque_.push_back(value);
+    }
+
+    std::optional<T> pop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (deque_.empty())
+            return std::nullopt;
+        T value = deque_.back();
+        deque_.pop_back();
+        return value;
+    }
+
+    std::optional<T> steal() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (deque_.empty())
+            return std::nullopt;
+        T value = deque_.front();
+        deque_.pop_front();
+        return value;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<T> deque_;
+};
+
+// The owner pushes kTasks tasks and pops one of every four itself, thieves steal
+// what they can; prints the time until all are taken and how many were stolen
+template <typename Queue>
+void StealTest(const char* name, size_t thieves) {
+    const long long kTasks = 4'000'000;
+
+    Queue queue;
+    std::atomic<bool> done{false};
+    std::atomic<long long> sum{0};
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thieves; ++t) {
+        threads.emplace_back([&] {
+            long long local_sum = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                if (auto task = queue.steal())
+                    local_sum += *task;
+                else
+                    std::this_thread::yield();
+            }
+            sum.fetch_add(local_sum, std::memory_order_relaxed);
+        });
+    }
+
+    long long owner_sum = 0;
+    long long popped = 0;
+    for (long long i = 0; i < kTasks; ++i) {
+        queue.push(i);
+        if (i % 4 == 0) {
+            if (auto task = queue.pop()) {
+                owner_sum += *task;
+                ++popped;
+            }
+        }
+    }
+    // Once the owner finds the queue empty every task has been taken
+    while (auto task = queue.pop()) {
+        owner_sum += *task;
+        ++popped;
+    }
+    done.store(true, std::memory_order_relaxed);
+    for (auto& thread : threads)
+        thread.join();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    sink = sum.load() + owner_sum;
+    long long all_stolen = kTasks - popped;
+    std::cerr << "  " << name << thieves << " thieves: " << elapsed << " ms, " << all_stolen << " stolen, "
+              << (elapsed > 0 ? all_stolen / elapsed / 1000 : 0) << " M steals/s" << std::endl;
+}
+
+void BenchmarkWorkStealing() {
+    std::cerr << "Work stealing, 4M tasks pushed by one owner (" << std::thread::hardware_concurrency()
+              << " hardware threads):" << std::endl;
+    for (size_t thieves : {1, 2, 4, 8}) {
+        StealTest<WorkStealingDeque<long long>>("WorkStealingDeque:      ", thieves);
+        StealTest<LockedDeque<long long>>("std::deque with mutex:  ", thieves);
+    }
+}
+
+// Sum, find of a missing value, fill and copy out, over the whole container, rounds times
+template <typename Container, typename Accumulate, typename Find, typename Fill, typename Copy>
+void AlgorithmsTest(const char* name, Container& container, int rounds, Accumulate accumulate, Find find, Fill fill,
+                    Copy copy) {
+    auto middle = (container.end() - container.begin()) / 2;
+    Vector<int> out(static_cast<size_t>(container.end() - container.begin()));
+    long long sum = MeasureMs([&] {
+        for (int round = 0; round < rounds; ++round)
+            sink = accumulate(container.begin(), container.end(), 0LL);
+    });
+    long long found = MeasureMs([&] {
+        for (int round = 0; round < rounds; ++round)
+            sink = find(container.begin(), container.end(), -round) == container.end();
+    });
+    long long filled = MeasureMs([&] {
+        for (int round = 0; round < rounds; ++round) {
+            fill(container.begin(), container.end(), round);
+            sink = *(container.begin() + middle);
+        }
+    });
+    long long copied = MeasureMs([&] {
+        for (int round = 0; round < rounds; ++round) {
+            copy(container.begin(), container.end(), out.begin());
+            sink = *(out.begin() + middle);
+        }
+    });
+    std::cerr << "  " << name << "accumulate " << sum << " ms, find " << found << " ms, fill " << filled
+              << " ms, copy " << copied << " ms" << std::endl;
+}
+
+void BenchmarkSegmentedAlgorithms() {
+    // Small enough for the cache, so the loops and not the memory set the pace
+    const size_t kCount = 50'000;
+    const int kRounds = 5'000;
+
+    Deque<int> deque;
+    Vector<int> vector;
+    for (size_t i = 0; i < kCount; ++i) {
+        deque.push_back(static_cast<int>(i % 1000));
+        vector.PushBack(static_cast<int>(i % 1000));
+    }
+
+    auto std_accumulate = [](auto first, auto last, long long init) { return std::accumulate(first, last, init); };
+    auto std_find = [](auto first, auto last, int value) { return std::find(first, last, value); };
+    auto std_fill = [](auto first, auto last, int value) { std::fill(first, last, value); };
+    auto std_copy = [](auto first, auto last, auto out) { return std::copy(first, last, out); };
+    auto segmented_accumulate = [](auto first, auto last, long long init) { return segmented::Accumulate(first, last, init); };
+    auto segmented_find = [](auto first, auto last, int value) { return segmented::Find(first, last, value); };
+    auto segmented_fill = [](auto first, auto last, int value) { segmented::Fill(first, last, value); };
+    auto segmented_copy = [](auto first, auto last, auto out) { return segmented::Copy(first, last, out); };
+
+    std::cerr << "Algorithms over " << kCount << " int, " << kRounds << " times:" << std::endl;
+    AlgorithmsTest("Deque, std algorithms: ", deque, kRounds, std_accumulate, std_find, std_fill, std_copy);
+    AlgorithmsTest("Deque, segmented:      ", deque, kRounds, segmented_accumulate, segmented_find, segmented_fill,
+                   segmented_copy);
+    AlgorithmsTest("Vector:                ", vector, kRounds, std_accumulate, std_find, std_fill, std_copy);
+}
+
+int main() {
+    BenchmarkFifo();
+    BenchmarkStrings();
+    BenchmarkGeometry();
+    BenchmarkMiddleInsert();
+    BenchmarkWorkStealing();
+    BenchmarkSegmentedAlgorithms();
+}
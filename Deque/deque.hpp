@@ -1,15 +1,167 @@
 #ifndef DEQUE_H
 #define DEQUE_H
 #include <cstddef>
+#include <initializer_list>
 #include <iterator>
 #include <algorithm>
 #include <type_traits>
+#include <utility>
 #include <deque>
+#include <memory>
 
-template <typename T>
+// Chunk geometry policies. A chunk holds a power of two elements, so that iterators
+// split an index into chunk and position with a shift and a mask.
+
+namespace deque_detail {
+
+constexpr size_t FloorLog2(size_t value) {
+    size_t log = 0;
+    while (value >>= 1) {
+        ++log;
+    }
+    return log;
+}
+
+}  // namespace deque_detail
+
+// Chunks of about kBytes: as many elements as fit, rounded down to a power of two,
+// but at least kMinElements for large T
+template <size_t kBytes = 4096, size_t kMinElements = 16>
+struct ByteBudgetChunks {
+    template <typename T>
+    static constexpr size_t kChunkShift =
+        std::max(deque_detail::FloorLog2(kBytes / sizeof(T)), deque_detail::FloorLog2(kMinElements));
+};
+
+// kElements elements per chunk whatever their size
+template <size_t kElements>
+struct FixedChunks {
+    static_assert(kElements > 0 && (kElements & (kElements - 1)) == 0, "kElements must be a power of two");
+
+    template <typename T>
+    static constexpr size_t kChunkShift = deque_detail::FloorLog2(kElements);
+};
+
+// A contiguous run of Deque elements, all in one chunk
+template <typename U>
+struct DequeSegment {
+    U* data;
+    size_t size;
+
+    U* begin() const {
+        return data;
+    }
+
+    U* end() const {
+        return data + size;
+    }
+};
+
+// The contiguous runs of the Deque elements from first to last, front to back: loops over
+// each run are plain pointer loops, without the chunk boundary check of iterator increments
+template <typename It>
+class SegmentRange {
+public:
+    using segment_type = typename It::segment_type;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = segment_type;
+        using difference_type = ptrdiff_t;
+        using pointer = const segment_type*;
+        using reference = segment_type;
+
+        iterator(It pos, It last) : pos_(pos), last_(last) {
+        }
+
+        segment_type operator*() const {
+            return pos_.segment(static_cast<size_t>(last_ - pos_));
+        }
+
+        iterator& operator++() {
+            pos_ += static_cast<difference_type>((**this).size);
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        bool operator==(const iterator& other) const {
+            return pos_ == other.pos_;
+        }
+
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        It pos_;
+        It last_;
+    };
+
+    SegmentRange(It first, It last) : first_(first), last_(last) {
+    }
+
+    iterator begin() const {
+        return iterator(first_, last_);
+    }
+
+    iterator end() const {
+        return iterator(last_, last_);
+    }
+
+private:
+    It first_;
+    It last_;
+};
+
+// Chunks and the map are allocated with Alloc rebound to T and to T*
+template <typename T, typename Alloc = std::allocator<T>, typename ChunkGeometry = ByteBudgetChunks<>>
 class Deque {
 private:
-    static const size_t kChunkSize = 128;
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using ChunkAllocator = typename AllocTraits::template rebind_alloc<T>;
+    using ChunkTraits = std::allocator_traits<ChunkAllocator>;
+    using MapAllocator = typename AllocTraits::template rebind_alloc<T*>;
+    using MapTraits = std::allocator_traits<MapAllocator>;
+
+    static constexpr size_t kChunkShift = ChunkGeometry::template kChunkShift<T>;
+    static constexpr size_t kChunkSize = size_t(1) << kChunkShift;
+    static constexpr size_t kChunkMask = kChunkSize - 1;
+    // Chunks emptied by pops are kept for the next pushes, up to this many
+    static const size_t kMaxSpareChunks = 2;
+
+    // The same value over and over, for insert(pos, count, value)
+    class RepeatIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        explicit RepeatIterator(const T* value) : value_(value) {
+        }
+
+        const T& operator*() const {
+            return *value_;
+        }
+
+        RepeatIterator& operator++() {
+            return *this;
+        }
+
+        RepeatIterator operator++(int) {
+            return *this;
+        }
+
+    private:
+        const T* value_;
+    };
 
     template <typename U>
     class BaseIterator {
@@ -19,15 +171,14 @@ private:
         using difference_type = ptrdiff_t;
         using pointer = value_type*;
         using reference = value_type&;
+        using segment_type = DequeSegment<U>;
 
         BaseIterator() = default;
         BaseIterator(U** chunk, size_t idx = 0) : chunk_ptr(chunk), internal_idx(idx) {
         }
 
         BaseIterator& operator++() {
-            if (internal_idx < kChunkSize - 1) {
-                internal_idx++;
-            } else {
+            if (++internal_idx == kChunkSize) {
                 chunk_ptr++;
                 internal_idx = 0;
             }
@@ -58,38 +209,20 @@ private:
             return copy;
         }
 
+        // The chunk step is the offset divided by the chunk size, rounded towards minus
+        // infinity. A negative offset is shifted as -offset - 1, since shifting a negative
+        // value right is implementation-defined before C++20. The mask of the two's complement
+        // offset gives the matching position either way.
         BaseIterator& operator+=(difference_type difference) {
-            if (difference < 0) {
-                return *this -= -difference;
-            }
-
-            size_t diff = static_cast<size_t>(difference);
-            if (internal_idx + diff < kChunkSize) {
-                internal_idx += diff;
-            } else {
-                diff += internal_idx;
-                chunk_ptr += diff / kChunkSize;
-                internal_idx = diff % kChunkSize;
-            }
+            difference_type offset = static_cast<difference_type>(internal_idx) + difference;
+            chunk_ptr += offset >= 0 ? offset >> kChunkShift : -((-offset - 1) >> kChunkShift) - 1;
+            internal_idx = static_cast<size_t>(offset) & kChunkMask;
 
             return *this;
         }
 
         BaseIterator& operator-=(difference_type difference) {
-            if (difference < 0) {
-                return *this += -difference;
-            }
-
-            size_t diff = static_cast<size_t>(difference);
-            if (internal_idx >= diff) {
-                internal_idx -= diff;
-            } else {
-                diff += kChunkSize - internal_idx - 1;
-                chunk_ptr -= diff / kChunkSize;
-                internal_idx = kChunkSize - diff % kChunkSize - 1;
-            }
-
-            return *this;
+            return *this += -difference;
         }
 
         BaseIterator operator+(difference_type diff) const {
@@ -114,12 +247,8 @@ private:
         }
 
         difference_type operator-(const BaseIterator& other) const {
-            if (chunk_ptr == other.chunk_ptr) {
-                return static_cast<difference_type>(internal_idx - other.internal_idx);
-            }
-
-            return static_cast<difference_type>(static_cast<size_t>(chunk_ptr - other.chunk_ptr) * kChunkSize +
-                                                internal_idx - other.internal_idx);
+            return (chunk_ptr - other.chunk_ptr) * static_cast<difference_type>(kChunkSize) +
+                   static_cast<difference_type>(internal_idx) - static_cast<difference_type>(other.internal_idx);
         }
 
         bool operator<(const BaseIterator& other) const {
@@ -146,11 +275,11 @@ private:
             return !(*this == other);
         }
 
-        U& operator*() {
+        U& operator*() const {
             return *GetObjectPtr();
         }
 
-        U* operator->() {
+        U* operator->() const {
             return GetObjectPtr();
         }
 
@@ -158,12 +287,19 @@ private:
             return it + diff;
         }
 
+        // The elements from this one to the end of its chunk, but at most max_size of them
+        segment_type segment(size_t max_size) const {
+            return segment_type{GetObjectPtr(), std::min(kChunkSize - internal_idx, max_size)};
+        }
+
         operator BaseIterator<const U>() const {
             return BaseIterator<const U>(const_cast<const T**>(chunk_ptr), internal_idx);
         }
 
     private:
-        U* GetObjectPtr() {
+        friend class Deque;
+
+        U* GetObjectPtr() const {
             return *chunk_ptr + internal_idx;
         }
 
@@ -174,27 +310,33 @@ private:
 
 public:
     using value_type = T;
+    using allocator_type = Alloc;
     using iterator = BaseIterator<T>;
     using const_iterator = BaseIterator<const T>;
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-    Deque() : chunks_count_(1), chunks_(CreateChunks(chunks_count_)) {
-        AllocateChunks(chunks_, 0, chunks_count_);
-        begin_ = end_ = DataBeginIterator() + kChunkSize / 2;
+    // Chunks are allocated when the first element is put into them, and the map with
+    // the first push, so an empty Deque owns no memory
+    Deque() : Deque(Alloc()) {
+    }
+
+    explicit Deque(const Alloc& alloc) : chunk_alloc_(alloc), map_alloc_(alloc) {
     }
 
-    explicit Deque(size_t size)
-        : chunks_count_(((size + 1) + 1) / kChunkSize + 1), chunks_(CreateChunks(chunks_count_)) {
+    explicit Deque(size_t size, const Alloc& alloc = Alloc())
+        : chunk_alloc_(alloc), map_alloc_(alloc),
+          chunks_count_(((size + 1) + 1) / kChunkSize + 1), chunks_(CreateChunks(chunks_count_)) {
         ConstructObjects(size);
     }
 
-    Deque(size_t size, const T& item)
-        : chunks_count_(((size + 1) + 1) / kChunkSize + 1), chunks_(CreateChunks(chunks_count_)) {
+    Deque(size_t size, const T& item, const Alloc& alloc = Alloc())
+        : chunk_alloc_(alloc), map_alloc_(alloc),
+          chunks_count_(((size + 1) + 1) / kChunkSize + 1), chunks_(CreateChunks(chunks_count_)) {
         ConstructObjects(size, item);
     }
 
-    Deque(const std::initializer_list<T> &list) : Deque() {
+    Deque(const std::initializer_list<T> &list, const Alloc& alloc = Alloc()) : Deque(alloc) {
         for (const auto& elem: list) {
             push_back(elem);
         }
@@ -202,39 +344,89 @@ public:
 
     ~Deque() {
         DestroyObjects(begin_, end_);
-        DeallocateChunks(chunks_, 0, chunks_count_);
-        DestroyChunks(chunks_);
+        FreeStorage();
     }
 
-    Deque(const Deque& other) : chunks_count_(other.chunks_count_), chunks_(CreateChunks(chunks_count_)) {
-        AllocateChunks(chunks_, 0, chunks_count_);
+    Deque(const Deque& other) : Deque(other, AllocTraits::select_on_container_copy_construction(other.get_allocator())) {
+    }
+
+    Deque(const Deque& other, const Alloc& alloc)
+        : chunk_alloc_(alloc), map_alloc_(alloc),
+          chunks_count_(other.chunks_count_), chunks_(CreateChunks(chunks_count_)) {
         begin_ = DataBeginIterator() + static_cast<ptrdiff_t>(other.begin_ - other.DataBeginIterator());
         end_ = DataBeginIterator() + static_cast<ptrdiff_t>(other.end_ - other.DataBeginIterator());
+        AllocateChunks(begin_, end_);
 
         for (auto it = begin_, other_it = other.begin_; it != end_; ++it, ++other_it) {
             try {
-                new (&(*it)) T(*other_it);
+                ChunkTraits::construct(chunk_alloc_, &(*it), *other_it);
             } catch (...) {
                 DestroyObjects(begin_, it);
-                DeallocateChunks(chunks_, 0, chunks_count_);
-                DestroyChunks(chunks_);
+                FreeStorage();
                 throw;
             }
         }
     }
 
+    // Takes the chunks and the map, other is left empty with the same allocator
+    Deque(Deque&& other) noexcept : chunk_alloc_(other.chunk_alloc_), map_alloc_(other.map_alloc_) {
+        SwapStorage(other);
+    }
+
     Deque& operator=(const Deque& other) {
         if (this != &other) {
-            Deque copy(other);
-            std::swap(chunks_count_, copy.chunks_count_);
-            std::swap(chunks_, copy.chunks_);
-            std::swap(begin_, copy.begin_);
-            std::swap(end_, copy.end_);
+            Deque copy(other, AllocTraits::propagate_on_container_copy_assignment::value ? other.get_allocator()
+                                                                                          : get_allocator());
+            SwapWithAllocator(copy);
+        }
+
+        return *this;
+    }
+
+    Deque& operator=(Deque&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                             AllocTraits::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value &&
+                      !AllocTraits::is_always_equal::value) {
+            if (!(chunk_alloc_ == other.chunk_alloc_)) {
+                // Chunks of another allocator can't be adopted, so the elements are moved one by one
+                Deque moved(get_allocator());
+                moved.ReserveBack(other.size());
+                for (T& elem : other) {
+                    moved.emplace_back(std::move(elem));
+                }
+                SwapWithAllocator(moved);
+                return *this;
+            }
+        }
+
+        // The old storage goes away with moved, which keeps the old allocator
+        Deque moved(get_allocator());
+        SwapStorage(moved);
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            chunk_alloc_ = other.chunk_alloc_;
+            map_alloc_ = other.map_alloc_;
         }
+        SwapStorage(other);
 
         return *this;
     }
 
+    void swap(Deque& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(chunk_alloc_, other.chunk_alloc_);
+            std::swap(map_alloc_, other.map_alloc_);
+        }
+        SwapStorage(other);
+    }
+
+    Alloc get_allocator() const {
+        return Alloc(chunk_alloc_);
+    }
+
     bool operator==(const Deque& other) const {
         if (size() == other.size()) {
             for (auto it1 = begin_, it2 = other.begin_; it1 != end_; ++it1, ++it2) {
@@ -289,11 +481,13 @@ public:
     }
 
     T& operator[](size_t idx) {
-        return *(begin_ + static_cast<ptrdiff_t>(idx));
+        size_t offset = begin_.internal_idx + idx;
+        return begin_.chunk_ptr[offset >> kChunkShift][offset & kChunkMask];
     }
 
     const T& operator[](size_t idx) const {
-        return *(begin_ + static_cast<ptrdiff_t>(idx));
+        size_t offset = begin_.internal_idx + idx;
+        return begin_.chunk_ptr[offset >> kChunkShift][offset & kChunkMask];
     }
 
     T& at(size_t idx) {
@@ -301,66 +495,153 @@ public:
             throw std::out_of_range("");
         }
 
-        return *(begin_ + idx);
+        return (*this)[idx];
     }
 
     const T& at(size_t idx) const {
         if (idx >= size()) {
             throw std::out_of_range("");
         }
-        return *(begin_ + idx);
+        return (*this)[idx];
     }
 
     void push_back(const T& item) {
-        if (end_ + 1 == iterator(chunks_ + chunks_count_ - 1, kChunkSize - 1)) {
-            IncreaseAndInsert(end_, item);
-        } else {
-            new (&(*end_)) T(item);
+        emplace_back(item);
+    }
+
+    void push_back(T&& item) {
+        emplace_back(std::move(item));
+    }
+
+    void push_front(const T& item) {
+        emplace_front(item);
+    }
+
+    void push_front(T&& item) {
+        emplace_front(std::move(item));
+    }
+
+    // Elements never move when the map grows, so args may refer to elements of this Deque
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        // end_ has to stay inside the map after the increment
+        if (chunks_count_ == 0 || (ChunkIndex(end_) == chunks_count_ - 1 && end_.internal_idx == kChunkSize - 1)) {
+            GrowMap(false, 1);
         }
 
+        Construct(end_, std::forward<Args>(args)...);
         end_++;
+        return back();
     }
 
-    void push_front(const T& item) {
-        if (begin_ - 1 == DataBeginIterator()) {
-            IncreaseAndInsert(begin_ - 1, item);
-        } else {
-            new (&(*(begin_ - 1))) T(item);
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        if (begin_ == DataBeginIterator()) {
+            GrowMap(true, 1);
         }
 
-        begin_--;
+        iterator new_begin = begin_ - 1;
+        Construct(new_begin, std::forward<Args>(args)...);
+        begin_ = new_begin;
+        return front();
     }
 
     void pop_back() {
-        (end_ - 1)->~T();
-        end_--;
+        ChunkTraits::destroy(chunk_alloc_, &(*(end_ - 1)));
+        DecrementEnd();
     }
 
     void pop_front() {
-        begin_->~T();
-        begin_++;
+        ChunkTraits::destroy(chunk_alloc_, &(*begin_));
+        IncrementBegin();
+    }
+
+    // Frees the spare chunks and fits the map to the chunks in use
+    void shrink_to_fit() {
+        if (chunks_count_ == 0) {
+            return;
+        }
+        // Released first, so that the chunk an empty deque kept goes with the spare ones
+        if (empty()) {
+            ReleaseChunk(begin_.chunk_ptr);
+        }
+        FreeSpareChunks();
+
+        size_t first = ChunkIndex(begin_);
+        size_t used = empty() ? 0 : ChunkIndex(end_ - 1) - first + 1;
+        // One chunk pointer more, for end_ after a full last chunk
+        if (used + 1 < chunks_count_) {
+            ReplaceMap(used + 1, 0);
+        }
     }
 
     iterator insert(iterator insert_it, const T& item) {
-        ptrdiff_t shift = insert_it - begin_;
-        push_back(item);
-        insert_it = begin_ + shift;
-        for (auto it = end_ - 1; it != insert_it; --it) {
-            std::swap(*it, *(it - 1));
+        return emplace(insert_it, item);
+    }
+
+    iterator insert(iterator insert_it, T&& item) {
+        return emplace(insert_it, std::move(item));
+    }
+
+    iterator insert(iterator insert_it, size_t count, const T& item) {
+        // A copy, in case item is an element that is about to move
+        T copy(item);
+        return InsertRange(insert_it, count, RepeatIterator(&copy));
+    }
+
+    template <typename InputIt, typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    iterator insert(iterator insert_it, InputIt first, InputIt last) {
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            return InsertRange(insert_it, static_cast<size_t>(std::distance(first, last)), first);
+        } else {
+            // One pass only: the elements have to be counted before anything moves
+            Deque buffer(get_allocator());
+            for (; first != last; ++first) {
+                buffer.emplace_back(*first);
+            }
+            return InsertRange(insert_it, buffer.size(), std::make_move_iterator(buffer.begin()));
         }
+    }
+
+    iterator insert(iterator insert_it, std::initializer_list<T> list) {
+        return InsertRange(insert_it, list.size(), list.begin());
+    }
 
-        return insert_it;
+    template <typename... Args>
+    iterator emplace(iterator insert_it, Args&&... args) {
+        // Built first: args may refer to an element that is about to move
+        T item(std::forward<Args>(args)...);
+        return InsertRange(insert_it, 1, std::make_move_iterator(&item));
     }
 
     iterator erase(iterator erase_it) {
-        erase_it->~T();
-        for (auto it = erase_it + 1; it != end_; ++it) {
-            new (&(*(it - 1))) T(*it);
-            it->~T();
+        return erase(erase_it, erase_it + 1);
+    }
+
+    // Moves the elements on the side of the range that has fewer of them
+    iterator erase(iterator first, iterator last) {
+        if (first == last) {
+            return first;
         }
-        end_--;
 
-        return erase_it;
+        size_t idx = static_cast<size_t>(first - begin_);
+        size_t count = static_cast<size_t>(last - first);
+        if (idx < size() - idx - count) {
+            MoveBackward(begin_, first, last);
+            for (size_t i = 0; i < count; ++i) {
+                ChunkTraits::destroy(chunk_alloc_, &(*begin_));
+                IncrementBegin();
+            }
+        } else {
+            Move(last, end_, first);
+            for (size_t i = 0; i < count; ++i) {
+                ChunkTraits::destroy(chunk_alloc_, &(*(end_ - 1)));
+                DecrementEnd();
+            }
+        }
+
+        return begin_ + static_cast<ptrdiff_t>(idx);
     }
 
     iterator begin() {
@@ -411,123 +692,364 @@ public:
         return rend();
     }
 
+    SegmentRange<iterator> segments() {
+        return SegmentRange<iterator>(begin_, end_);
+    }
+
+    SegmentRange<const_iterator> segments() const {
+        return SegmentRange<const_iterator>(begin_, end_);
+    }
+
+    // Calls func(pointer, count) for each contiguous run of elements, front to back
+    template <typename Func>
+    void for_each_segment(Func&& func) {
+        for (DequeSegment<T> segment : segments()) {
+            func(segment.data, segment.size);
+        }
+    }
+
+    template <typename Func>
+    void for_each_segment(Func&& func) const {
+        for (DequeSegment<const T> segment : segments()) {
+            func(segment.data, segment.size);
+        }
+    }
+
 private:
     T** CreateChunks(size_t chunks_count) {
-        return new T*[chunks_count];
+        if (chunks_count == 0) {
+            return nullptr;
+        }
+
+        T** chunks = MapTraits::allocate(map_alloc_, chunks_count);
+        std::fill(chunks, chunks + chunks_count, nullptr);
+        return chunks;
     }
 
-    void AllocateChunks(T** chunks, size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i) {
-            try {
-                chunks[i] = reinterpret_cast<T*>(new char[sizeof(T) * kChunkSize]);
-            } catch (...) {
-                DeallocateChunks(chunks, begin, i);
-                DestroyChunks(chunks);
-                throw;
+    void DestroyChunks(T** chunks, size_t chunks_count) {
+        if (chunks != nullptr) {
+            MapTraits::deallocate(map_alloc_, chunks, chunks_count);
+        }
+    }
+
+    T* AllocateChunk() {
+        if (spare_count_ > 0) {
+            return spare_chunks_[--spare_count_];
+        }
+
+        return ChunkTraits::allocate(chunk_alloc_, kChunkSize);
+    }
+
+    void DeallocateChunk(T* chunk) {
+        if (chunk != nullptr) {
+            ChunkTraits::deallocate(chunk_alloc_, chunk, kChunkSize);
+        }
+    }
+
+    void EnsureChunk(T** chunk_ptr) {
+        if (*chunk_ptr == nullptr) {
+            *chunk_ptr = AllocateChunk();
+        }
+    }
+
+    template <typename... Args>
+    void Construct(iterator it, Args&&... args) {
+        EnsureChunk(it.chunk_ptr);
+        ChunkTraits::construct(chunk_alloc_, &(*it), std::forward<Args>(args)...);
+    }
+
+    // Gives an empty chunk back: to the spare chunks if there is room, else to the heap
+    void ReleaseChunk(T** chunk_ptr) {
+        if (*chunk_ptr == nullptr) {
+            return;
+        }
+
+        if (spare_count_ < kMaxSpareChunks) {
+            spare_chunks_[spare_count_++] = *chunk_ptr;
+        } else {
+            DeallocateChunk(*chunk_ptr);
+        }
+        *chunk_ptr = nullptr;
+    }
+
+    // Allocates the chunks holding [begin, end), freeing everything on failure
+    void AllocateChunks(iterator begin, iterator end) {
+        if (begin == end) {
+            return;
+        }
+
+        try {
+            for (T** chunk_ptr = begin.chunk_ptr; chunk_ptr <= (end - 1).chunk_ptr; ++chunk_ptr) {
+                EnsureChunk(chunk_ptr);
             }
+        } catch (...) {
+            FreeStorage();
+            throw;
         }
     }
 
+    void ReleaseChunks(T** first, T** last) {
+        for (; first != last; ++first) {
+            ReleaseChunk(first);
+        }
+    }
+
+    void FreeSpareChunks() {
+        for (; spare_count_ > 0; --spare_count_) {
+            DeallocateChunk(spare_chunks_[spare_count_ - 1]);
+        }
+    }
+
+    // Chunks, spare chunks and the map, once the elements are destroyed
+    void FreeStorage() {
+        for (size_t i = 0; i < chunks_count_; ++i) {
+            DeallocateChunk(chunks_[i]);
+        }
+        FreeSpareChunks();
+        DestroyChunks(chunks_, chunks_count_);
+    }
+
     template <typename... Args>
     void ConstructObjects(size_t size, const Args&... args) {
-        AllocateChunks(chunks_, 0, chunks_count_);
         begin_ = DataBeginIterator() + 1;
         end_ = begin_ + static_cast<ptrdiff_t>(size);
+        AllocateChunks(begin_, end_);
 
         for (iterator it = begin_; it != end_; ++it) {
             try {
-                new (&(*it)) T(args...);
+                ChunkTraits::construct(chunk_alloc_, &(*it), args...);
             } catch (...) {
                 DestroyObjects(begin_, it);
-                DeallocateChunks(chunks_, 0, chunks_count_);
-                DestroyChunks(chunks_);
+                FreeStorage();
                 throw;
             }
         }
     }
 
-    void DestroyChunks(T** chunks) {
-        delete[] chunks;
+    void DestroyObjects(iterator begin, iterator end) {
+        for (auto it = begin; it != end; ++it) {
+            ChunkTraits::destroy(chunk_alloc_, &(*it));
+        }
+    }
+
+    iterator DataBeginIterator() const {
+        return iterator(chunks_, 0);
     }
 
-    void DeallocateChunks(T** chunks, size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i) {
-            delete[] reinterpret_cast<char*>(chunks[i]);
+    size_t ChunkIndex(iterator it) const {
+        return static_cast<size_t>(it.chunk_ptr - chunks_);
+    }
+
+    // After the front element is destroyed: a chunk left behind holds nothing anymore
+    void IncrementBegin() {
+        T** chunk_ptr = begin_.chunk_ptr;
+        begin_++;
+        if (begin_.chunk_ptr != chunk_ptr) {
+            ReleaseChunk(chunk_ptr);
         }
     }
 
-    void DestroyObjects(iterator begin, iterator end) {
-        for (auto it = begin; it != end; ++it) {
-            it->~T();
+    // After the back element is destroyed
+    void DecrementEnd() {
+        T** chunk_ptr = end_.chunk_ptr;
+        end_--;
+        if (end_.chunk_ptr != chunk_ptr) {
+            ReleaseChunk(chunk_ptr);
         }
     }
 
-    iterator DataBeginIterator() const {
-        return iterator(chunks_, 0);
+    // std::move and std::move_backward within this Deque, one contiguous run of both
+    // ranges at a time, so that trivial elements are moved with memmove
+    iterator Move(iterator first, iterator last, iterator dest) {
+        while (first != last) {
+            size_t count = std::min({kChunkSize - first.internal_idx, kChunkSize - dest.internal_idx,
+                                     static_cast<size_t>(last - first)});
+            std::move(first.GetObjectPtr(), first.GetObjectPtr() + count, dest.GetObjectPtr());
+            first += static_cast<ptrdiff_t>(count);
+            dest += static_cast<ptrdiff_t>(count);
+        }
+        return dest;
     }
 
-    void IncreaseAndInsert(iterator it, const T& item) {
-        ptrdiff_t shift = it - begin_;
+    iterator MoveBackward(iterator first, iterator last, iterator dest_last) {
+        while (first != last) {
+            // Runs end at last and dest_last, an index of 0 means the whole previous chunk
+            size_t count = std::min({((last.internal_idx - 1) & kChunkMask) + 1,
+                                     ((dest_last.internal_idx - 1) & kChunkMask) + 1,
+                                     static_cast<size_t>(last - first)});
+            T* source_end = (last - 1).GetObjectPtr() + 1;
+            std::move_backward(source_end - count, source_end, (dest_last - 1).GetObjectPtr() + 1);
+            last -= static_cast<ptrdiff_t>(count);
+            dest_last -= static_cast<ptrdiff_t>(count);
+        }
+        return dest_last;
+    }
 
-        size_t unused_chunks_left = static_cast<size_t>(begin_ - DataBeginIterator()) / kChunkSize;
-        size_t unused_chunks_right =
-            chunks_count_ - static_cast<size_t>(end_ - DataBeginIterator() - 1) / kChunkSize - 1;
+    // Makes room for extra_chunks more chunks at the front or at the back. The map is only
+    // reallocated if it is more than half full, otherwise the chunks in use are moved
+    // to its middle, so a queue that pushes at one end and pops at the other keeps its map.
+    void GrowMap(bool at_front, size_t extra_chunks) {
+        if (chunks_count_ == 0) {
+            chunks_count_ = 2 * extra_chunks + 1;
+            chunks_ = CreateChunks(chunks_count_);
+            begin_ = end_ = iterator(chunks_ + extra_chunks, kChunkSize / 2);
+            return;
+        }
 
-        size_t add_chunks_count = chunks_count_;
-        if ((add_chunks_count + unused_chunks_right - unused_chunks_left) % 2) {
-            ++add_chunks_count;
+        size_t used = ChunkIndex(end_) - ChunkIndex(begin_) + 1;
+        size_t new_chunks_count = chunks_count_;
+        if (2 * (used + extra_chunks) > chunks_count_) {
+            new_chunks_count = std::max(2 * chunks_count_ + 1, 2 * (used + extra_chunks));
         }
 
-        size_t add_chunks_left = (add_chunks_count + unused_chunks_right - unused_chunks_left) / 2;
+        // Rounded towards the end that grows
+        size_t free_chunks = new_chunks_count - used;
+        ReplaceMap(new_chunks_count, at_front ? (free_chunks + 1) / 2 : free_chunks / 2);
+    }
 
-        size_t new_chunks_count = chunks_count_ + add_chunks_count;
+    // Makes sure count elements more fit before begin_, without another map change
+    void ReserveFront(size_t count) {
+        size_t free = chunks_count_ == 0 ? 0 : ChunkIndex(begin_) * kChunkSize + begin_.internal_idx;
+        if (free < count) {
+            GrowMap(true, (count + kChunkSize - 1) >> kChunkShift);
+        }
+    }
 
-        T** new_chunks = CreateChunks(new_chunks_count);
-        AllocateChunks(new_chunks, 0, add_chunks_left);
-        try {
-            AllocateChunks(new_chunks, add_chunks_left + chunks_count_, new_chunks_count);
-        } catch (...) {
-            DeallocateChunks(new_chunks, 0, add_chunks_left);
-            throw;
+    // The same after end_, which has to stay inside the map
+    void ReserveBack(size_t count) {
+        size_t free = chunks_count_ == 0 ? 0 : (chunks_count_ - ChunkIndex(end_)) * kChunkSize - end_.internal_idx - 1;
+        if (free < count) {
+            GrowMap(false, (count + kChunkSize - 1) >> kChunkShift);
         }
+    }
 
-        try {
-            std::copy(chunks_, chunks_ + chunks_count_, new_chunks + add_chunks_left);
-        } catch (...) {
-            DeallocateChunks(new_chunks, 0, add_chunks_left);
-            DeallocateChunks(new_chunks, add_chunks_left + chunks_count_, new_chunks_count);
-            throw;
+    // Inserts count elements copied from first at insert_it, moving the elements on the
+    // side with fewer of them by count positions, each with one move. The new slots at that
+    // end are filled first, with the moved elements or the values; if that throws, the
+    // Deque is left as it was.
+    template <typename ForwardIt>
+    iterator InsertRange(iterator insert_it, size_t count, ForwardIt first) {
+        size_t idx = static_cast<size_t>(insert_it - begin_);
+        size_t after = size() - idx;
+        if (count == 0) {
+            return insert_it;
         }
 
-        it = iterator(new_chunks, 0) +
-             static_cast<ptrdiff_t>(begin_ - DataBeginIterator() +
-                                    static_cast<ptrdiff_t>(kChunkSize * add_chunks_left)) +
-             shift;
-        try {
-            new (&(*it)) T(item);
-        } catch (...) {
-            DeallocateChunks(new_chunks, 0, add_chunks_left);
-            DeallocateChunks(new_chunks, add_chunks_left + chunks_count_, new_chunks_count);
-            throw;
+        if (idx < after) {
+            ReserveFront(count);
+            iterator old_begin = begin_;
+            iterator new_begin = begin_ - static_cast<ptrdiff_t>(count);
+            // The first min(count, idx) elements go to new slots, after the values that
+            // don't fit before old_begin. Values first, so nothing has moved if they throw.
+            size_t moved = std::min(count, idx);
+            iterator values_begin = new_begin + static_cast<ptrdiff_t>(moved);
+            iterator it = values_begin;
+            try {
+                for (; it != old_begin; ++it, ++first) {
+                    Construct(it, *first);
+                }
+            } catch (...) {
+                DestroyObjects(values_begin, it);
+                ReleaseChunks(new_begin.chunk_ptr, old_begin.chunk_ptr);
+                throw;
+            }
+            it = new_begin;
+            try {
+                for (size_t i = 0; i < moved; ++i, ++it) {
+                    Construct(it, std::move_if_noexcept(*(old_begin + static_cast<ptrdiff_t>(i))));
+                }
+            } catch (...) {
+                DestroyObjects(new_begin, it);
+                DestroyObjects(values_begin, old_begin);
+                ReleaseChunks(new_begin.chunk_ptr, old_begin.chunk_ptr);
+                throw;
+            }
+            begin_ = new_begin;
+
+            iterator gap = begin_ + static_cast<ptrdiff_t>(idx);
+            Move(begin_ + static_cast<ptrdiff_t>(count + moved), gap + static_cast<ptrdiff_t>(count),
+                 begin_ + static_cast<ptrdiff_t>(moved));
+            std::copy_n(first, moved, gap + static_cast<ptrdiff_t>(count - moved));
+        } else {
+            ReserveBack(count);
+            iterator old_end = end_;
+            // The last min(count, after) elements go to new slots, after the values that
+            // don't fit before old_end
+            size_t moved = std::min(count, after);
+            ForwardIt values = std::next(first, static_cast<ptrdiff_t>(moved));
+            iterator it = old_end;
+            try {
+                for (size_t i = moved; i < count; ++i, ++it, ++values) {
+                    Construct(it, *values);
+                }
+                for (iterator from = old_end - static_cast<ptrdiff_t>(moved); from != old_end; ++from, ++it) {
+                    Construct(it, std::move_if_noexcept(*from));
+                }
+            } catch (...) {
+                DestroyObjects(old_end, it);
+                ReleaseChunks(old_end.chunk_ptr + 1, (old_end + static_cast<ptrdiff_t>(count)).chunk_ptr + 1);
+                throw;
+            }
+            end_ = it;
+
+            iterator gap = begin_ + static_cast<ptrdiff_t>(idx);
+            MoveBackward(gap, old_end - static_cast<ptrdiff_t>(moved), old_end + static_cast<ptrdiff_t>(count - moved));
+            std::copy_n(first, moved, gap);
         }
 
-        DestroyChunks(chunks_);
+        return begin_ + static_cast<ptrdiff_t>(idx);
+    }
 
-        ptrdiff_t begin_shift = begin_ - DataBeginIterator() + static_cast<ptrdiff_t>(kChunkSize * add_chunks_left);
-        ptrdiff_t end_shift = end_ - DataBeginIterator() + static_cast<ptrdiff_t>(kChunkSize * add_chunks_left);
+    // Moves the chunk pointers from begin_ to end_ to a map of new_chunks_count pointers,
+    // starting at pointer first. The map is reused if the size doesn't change.
+    void ReplaceMap(size_t new_chunks_count, size_t first) {
+        size_t old_first = ChunkIndex(begin_);
+        size_t used = ChunkIndex(end_) - old_first + 1;
+
+        T** new_chunks = chunks_;
+        if (new_chunks_count != chunks_count_) {
+            new_chunks = CreateChunks(new_chunks_count);
+            std::copy(chunks_ + old_first, chunks_ + old_first + used, new_chunks + first);
+            DestroyChunks(chunks_, chunks_count_);
+        } else if (first < old_first) {
+            std::copy(chunks_ + old_first, chunks_ + old_first + used, chunks_ + first);
+            std::fill(chunks_ + std::max(first + used, old_first), chunks_ + old_first + used, nullptr);
+        } else if (first > old_first) {
+            std::copy_backward(chunks_ + old_first, chunks_ + old_first + used, chunks_ + first + used);
+            std::fill(chunks_ + old_first, chunks_ + std::min(first, old_first + used), nullptr);
+        }
 
+        begin_ = iterator(new_chunks + first, begin_.internal_idx);
+        end_ = iterator(new_chunks + first + used - 1, end_.internal_idx);
         chunks_ = new_chunks;
         chunks_count_ = new_chunks_count;
+    }
+
+    void SwapStorage(Deque& other) noexcept {
+        std::swap(chunks_count_, other.chunks_count_);
+        std::swap(chunks_, other.chunks_);
+        std::swap(begin_, other.begin_);
+        std::swap(end_, other.end_);
+        std::swap(spare_chunks_, other.spare_chunks_);
+        std::swap(spare_count_, other.spare_count_);
+    }
 
-        begin_ = DataBeginIterator() + begin_shift;
-        end_ = DataBeginIterator() + end_shift;
+    void SwapWithAllocator(Deque& other) noexcept {
+        std::swap(chunk_alloc_, other.chunk_alloc_);
+        std::swap(map_alloc_, other.map_alloc_);
+        SwapStorage(other);
     }
 
 private:
+    // Declared first: the constructors allocate the map in their initializer lists
+    ChunkAllocator chunk_alloc_;
+    MapAllocator map_alloc_;
     size_t chunks_count_ = 0;
     T** chunks_ = nullptr;
     iterator begin_ = iterator();
     iterator end_ = iterator();
+    T* spare_chunks_[kMaxSpareChunks] = {};
+    size_t spare_count_ = 0;
 };
 
 #endif
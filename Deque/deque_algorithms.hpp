@@ -0,0 +1,114 @@
+#ifndef DEQUE_ALGORITHMS_H
+#define DEQUE_ALGORITHMS_H
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+#include "deque.hpp"
+
+// The std algorithms, except that a range of Deque iterators is walked one chunk at a
+// time: every contiguous run gets a loop over plain pointers, which the compiler can
+// unroll and vectorize, and std::copy and std::fill turn into memmove and memset for
+// trivial types. Any other iterators go to the std algorithm directly. They live in
+// namespace segmented, apart from the std ones and the SIMD algorithms of Vector.
+
+namespace segmented {
+
+// Iterators that can hand out contiguous runs, see BaseIterator::segment
+template <typename It, typename = void>
+struct IsSegmentedIterator : std::false_type {};
+
+template <typename It>
+struct IsSegmentedIterator<It, std::void_t<typename It::segment_type>> : std::true_type {};
+
+template <typename It, typename Func>
+Func ForEach(It first, It last, Func func) {
+    if constexpr (IsSegmentedIterator<It>::value) {
+        for (auto segment : SegmentRange<It>(first, last)) {
+            for (auto& elem : segment) {
+                func(elem);
+            }
+        }
+        return func;
+    } else {
+        return std::for_each(first, last, std::move(func));
+    }
+}
+
+// Segmented on either side: a random access source is copied straight into the
+// contiguous runs of a Deque destination
+template <typename InputIt, typename OutputIt>
+OutputIt Copy(InputIt first, InputIt last, OutputIt out) {
+    using Category = typename std::iterator_traits<InputIt>::iterator_category;
+    if constexpr (IsSegmentedIterator<InputIt>::value) {
+        for (auto segment : SegmentRange<InputIt>(first, last)) {
+            out = Copy(segment.begin(), segment.end(), out);
+        }
+        return out;
+    } else if constexpr (IsSegmentedIterator<OutputIt>::value &&
+                         std::is_base_of_v<std::random_access_iterator_tag, Category>) {
+        while (first != last) {
+            auto segment = out.segment(static_cast<size_t>(last - first));
+            auto count = static_cast<ptrdiff_t>(segment.size);
+            std::copy(first, first + count, segment.data);
+            first += count;
+            out += count;
+        }
+        return out;
+    } else {
+        return std::copy(first, last, out);
+    }
+}
+
+template <typename It, typename T>
+void Fill(It first, It last, const T& value) {
+    if constexpr (IsSegmentedIterator<It>::value) {
+        for (auto segment : SegmentRange<It>(first, last)) {
+            std::fill(segment.begin(), segment.end(), value);
+        }
+    } else {
+        std::fill(first, last, value);
+    }
+}
+
+template <typename It, typename T>
+It Find(It first, It last, const T& value) {
+    if constexpr (IsSegmentedIterator<It>::value) {
+        while (first != last) {
+            auto segment = first.segment(static_cast<size_t>(last - first));
+            auto found = std::find(segment.begin(), segment.end(), value);
+            first += found - segment.begin();
+            if (found != segment.end()) {
+                return first;
+            }
+        }
+        return last;
+    } else {
+        return std::find(first, last, value);
+    }
+}
+
+template <typename It, typename T, typename BinaryOp>
+T Accumulate(It first, It last, T init, BinaryOp op) {
+    if constexpr (IsSegmentedIterator<It>::value) {
+        for (auto segment : SegmentRange<It>(first, last)) {
+            init = std::accumulate(segment.begin(), segment.end(), std::move(init), op);
+        }
+        return init;
+    } else {
+        return std::accumulate(first, last, std::move(init), op);
+    }
+}
+
+template <typename It, typename T>
+T Accumulate(It first, It last, T init) {
+    return Accumulate(first, last, std::move(init), std::plus<>());
+}
+
+}  // namespace segmented
+
+#endif
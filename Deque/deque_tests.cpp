@@ -3,8 +3,18 @@
 #include "catch.hpp"
 
 #include "deque.hpp"
+#include "deque_algorithms.hpp"
+#include "work_stealing_deque.hpp"
 
+#include <atomic>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <memory>
+#include <random>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <deque>
 
@@ -21,6 +31,723 @@ TEST_CASE("Trying 3000000 size...") {
     }
 }
 
+TEST_CASE("Chunk recycling") {
+    SECTION("FIFO queue") {
+        Deque<std::string> d;
+        std::deque<std::string> true_d;
+        for (int i = 0; i < 100'000; ++i) {
+            d.push_back(std::to_string(i));
+            true_d.push_back(std::to_string(i));
+            if (i % 3 != 0) {
+                d.pop_front();
+                true_d.pop_front();
+            }
+        }
+        REQUIRE(d == true_d);
+
+        while (!d.empty()) {
+            REQUIRE(d.front() == true_d.front());
+            d.pop_front();
+            true_d.pop_front();
+        }
+        d.push_front("again");
+        REQUIRE(d.back() == "again");
+    }
+
+    SECTION("Both ends past the map") {
+        Deque<int> d;
+        std::deque<int> true_d;
+        for (int round = 0; round < 20; ++round) {
+            for (int i = 0; i < 1000; ++i) {
+                d.push_front(i);
+                true_d.push_front(i);
+                d.push_back(-i);
+                true_d.push_back(-i);
+            }
+            for (int i = 0; i < 900; ++i) {
+                d.pop_back();
+                true_d.pop_back();
+                d.pop_front();
+                true_d.pop_front();
+            }
+        }
+        REQUIRE(d == true_d);
+        REQUIRE(d.end() - d.begin() == 4000);
+    }
+
+    SECTION("shrink_to_fit") {
+        Deque<int> d(10'000, 1);
+        for (int i = 0; i < 9'900; ++i) {
+            d.pop_front();
+        }
+        d.push_back(2);
+        d.shrink_to_fit();
+        REQUIRE(d.size() == 101);
+        REQUIRE(d.front() == 1);
+        REQUIRE(d.back() == 2);
+
+        d.push_front(0);
+        d.push_back(3);
+        REQUIRE(d[0] == 0);
+        REQUIRE(d[102] == 3);
+
+        Deque<int> empty(300, 1);
+        while (!empty.empty()) {
+            empty.pop_back();
+        }
+        empty.shrink_to_fit();
+        empty.push_front(5);
+        empty.push_back(6);
+        REQUIRE(empty == Deque<int>{5, 6});
+
+        Deque<int> fresh;
+        fresh.shrink_to_fit();
+        REQUIRE(fresh.empty());
+        REQUIRE(fresh.begin() == fresh.end());
+    }
+}
+
+TEST_CASE("Move semantics") {
+    SECTION("Move-only elements") {
+        Deque<std::unique_ptr<int>> d;
+        for (int i = 0; i < 300; ++i) {
+            d.push_back(std::make_unique<int>(i));
+            d.emplace_front(new int(-i));
+        }
+        REQUIRE(d.size() == 600);
+        REQUIRE(*d.front() == -299);
+        REQUIRE(*d.back() == 299);
+
+        auto ptr = std::make_unique<int>(1000);
+        d.insert(d.begin() + 100, std::move(ptr));
+        REQUIRE(ptr == nullptr);
+        REQUIRE(*d[100] == 1000);
+        REQUIRE(*d[101] == -199);
+
+        auto it = d.emplace(d.begin() + 450, new int(2000));
+        REQUIRE(**it == 2000);
+        REQUIRE(*d[451] == 149);
+        d.emplace(d.end(), new int(3000));
+        REQUIRE(*d.back() == 3000);
+
+        d.erase(d.begin() + 100);
+        d.erase(d.begin() + 449);
+        REQUIRE(*d[100] == -199);
+        REQUIRE(*d[449] == 149);
+        d.pop_back();
+        REQUIRE(*d.back() == 299);
+
+        int& emplaced = *d.emplace_back(new int(4000));
+        REQUIRE(emplaced == 4000);
+        REQUIRE(d.size() == 601);
+    }
+
+    SECTION("Move constructor and assignment") {
+        Deque<std::unique_ptr<int>> d;
+        for (int i = 0; i < 1000; ++i) {
+            d.push_back(std::make_unique<int>(i));
+        }
+        int* first = d.front().get();
+
+        Deque<std::unique_ptr<int>> moved(std::move(d));
+        REQUIRE(moved.size() == 1000);
+        REQUIRE(moved.front().get() == first);
+        REQUIRE(d.empty());
+        REQUIRE(d.begin() == d.end());
+
+        // A moved-from Deque can be used again
+        d.push_front(std::make_unique<int>(7));
+        d.push_back(std::make_unique<int>(8));
+        REQUIRE(*d.front() == 7);
+        REQUIRE(*d.back() == 8);
+
+        d = std::move(moved);
+        REQUIRE(d.size() == 1000);
+        REQUIRE(*d[999] == 999);
+        REQUIRE(d.front().get() == first);
+
+        auto make = [] {
+            Deque<std::unique_ptr<int>> local;
+            local.emplace_back(new int(5));
+            return local;
+        };
+        Deque<std::unique_ptr<int>> returned = make();
+        REQUIRE(*returned.front() == 5);
+    }
+
+    SECTION("Empty Deque") {
+        Deque<std::string> d;
+        REQUIRE(d.empty());
+        REQUIRE(d.size() == 0);
+        Deque<std::string> copy = d;
+        copy.shrink_to_fit();
+        copy.insert(copy.begin(), "a");
+        copy.emplace(copy.begin(), 3, 'b');
+        REQUIRE(copy == Deque<std::string>{"bbb", "a"});
+
+        std::string s = "moved into the deque, long enough to be on the heap";
+        const char* data = s.data();
+        d.push_back(std::move(s));
+        REQUIRE(d.front().data() == data);
+        d.emplace_back(d.front());
+        REQUIRE(d.back() == d.front());
+    }
+}
+
+template <typename D>
+static void CheckIteratorArithmetic(D& d, const std::deque<int>& true_d) {
+    REQUIRE(d == true_d);
+    for (ptrdiff_t from = 0; from <= static_cast<ptrdiff_t>(d.size()); from += 7) {
+        for (ptrdiff_t to = 0; to <= static_cast<ptrdiff_t>(d.size()); to += 5) {
+            auto it = d.begin() + from;
+            REQUIRE((it + (to - from)) - d.begin() == to);
+            REQUIRE((it - (from - to)) == d.begin() + to);
+            REQUIRE((d.begin() + to) - it == to - from);
+            if (to < static_cast<ptrdiff_t>(d.size())) {
+                REQUIRE(*(it + (to - from)) == true_d[to]);
+                REQUIRE(d[to] == true_d[to]);
+            }
+        }
+    }
+}
+
+TEST_CASE("Chunk geometry") {
+    SECTION("Tiny chunks") {
+        Deque<int, std::allocator<int>, FixedChunks<4>> d;
+        std::deque<int> true_d;
+        for (int i = 0; i < 100; ++i) {
+            d.push_back(i);
+            true_d.push_back(i);
+            d.push_front(-i);
+            true_d.push_front(-i);
+        }
+        CheckIteratorArithmetic(d, true_d);
+
+        for (int i = 0; i < 37; ++i) {
+            d.pop_front();
+            true_d.pop_front();
+        }
+        d.erase(d.begin() + 50);
+        true_d.erase(true_d.begin() + 50);
+        d.insert(d.begin() + 13, 1000);
+        true_d.insert(true_d.begin() + 13, 1000);
+        CheckIteratorArithmetic(d, true_d);
+    }
+
+    SECTION("Large negative steps") {
+        Deque<int> d;
+        for (int i = 0; i < 10'000; ++i) {
+            d.push_back(i);
+        }
+        // Starts the deque in the middle of a chunk
+        for (int i = 0; i < 13; ++i) {
+            d.pop_front();
+        }
+
+        for (ptrdiff_t from : {9'986, 5'003, 777}) {
+            for (ptrdiff_t step : {ptrdiff_t(1), ptrdiff_t(700), ptrdiff_t(4'099), from - 1, from}) {
+                if (step > from) {
+                    continue;
+                }
+                auto it = d.begin() + from;
+                it += -step;
+                REQUIRE(it - d.begin() == from - step);
+                REQUIRE(*it == static_cast<int>(from - step) + 13);
+
+                auto back = d.begin() + from;
+                back -= step;
+                REQUIRE(back == it);
+            }
+        }
+    }
+
+    SECTION("Byte budget") {
+        Deque<int, std::allocator<int>, ByteBudgetChunks<64>> d(1000, 3);
+        std::deque<int> true_d(1000, 3);
+        d.push_front(1);
+        true_d.push_front(1);
+        CheckIteratorArithmetic(d, true_d);
+
+        struct Big {
+            char bytes[1000];
+        };
+        // Four Big in 4096 bytes, raised to the 16 element minimum
+        Deque<Big> big(100);
+        big[99].bytes[999] = 'x';
+        size_t segments = 0;
+        big.for_each_segment([&segments](Big*, size_t count) {
+            REQUIRE(count <= 16);
+            ++segments;
+        });
+        REQUIRE(segments >= 7);
+        REQUIRE(big.at(99).bytes[999] == 'x');
+    }
+}
+
+// Throws from the copy constructor once copies_left copies have been made
+struct ThrowingCopy {
+    static inline int copies_left = 1'000'000;
+    int value = 0;
+
+    ThrowingCopy(int value = 0) : value(value) {
+    }
+
+    ThrowingCopy(const ThrowingCopy& other) : value(other.value) {
+        if (--copies_left < 0) {
+            throw std::runtime_error("copy");
+        }
+    }
+
+    ThrowingCopy(ThrowingCopy&&) noexcept = default;
+    ThrowingCopy& operator=(const ThrowingCopy&) = default;
+    ThrowingCopy& operator=(ThrowingCopy&&) noexcept = default;
+
+    bool operator!=(const ThrowingCopy& other) const {
+        return value != other.value;
+    }
+};
+
+template <typename D>
+static void RandomRangeOperations(unsigned int seed) {
+    std::srand(seed);
+    D d;
+    std::deque<int> true_d;
+    for (int counter = 0; counter < 3000; ++counter) {
+        size_t pos = true_d.empty() ? 0 : static_cast<size_t>(std::rand()) % (true_d.size() + 1);
+        size_t count = static_cast<size_t>(std::rand() % 40);
+        int value = std::rand() % 100;
+
+        switch (std::rand() % 6) {
+            case 0: {
+                std::vector<int> values(count, value);
+                std::iota(values.begin(), values.end(), value);
+                auto it = d.insert(d.begin() + pos, values.begin(), values.end());
+                true_d.insert(true_d.begin() + pos, values.begin(), values.end());
+                REQUIRE(it - d.begin() == static_cast<ptrdiff_t>(pos));
+                break;
+            }
+            case 1: {
+                std::list<int> values(count, value);
+                d.insert(d.begin() + pos, values.begin(), values.end());
+                true_d.insert(true_d.begin() + pos, values.begin(), values.end());
+                break;
+            }
+            case 2: {
+                std::istringstream in("1 2 3 4 5 6 7");
+                d.insert(d.begin() + pos, std::istream_iterator<int>(in), std::istream_iterator<int>());
+                true_d.insert(true_d.begin() + pos, {1, 2, 3, 4, 5, 6, 7});
+                break;
+            }
+            case 3: {
+                // The value is an element of the deque itself
+                if (!true_d.empty()) {
+                    size_t from = static_cast<size_t>(std::rand()) % true_d.size();
+                    d.insert(d.begin() + pos, count, d[from]);
+                    int copy = true_d[from];
+                    true_d.insert(true_d.begin() + pos, count, copy);
+                }
+                break;
+            }
+            default: {
+                size_t erased = std::min(count, true_d.size() - pos);
+                auto it = d.erase(d.begin() + pos, d.begin() + pos + erased);
+                true_d.erase(true_d.begin() + pos, true_d.begin() + pos + erased);
+                REQUIRE(it - d.begin() == static_cast<ptrdiff_t>(pos));
+                break;
+            }
+        }
+        REQUIRE(d == true_d);
+    }
+}
+
+TEST_CASE("Range insert and erase") {
+    SECTION("Random ranges") {
+        RandomRangeOperations<Deque<int>>(1);
+        RandomRangeOperations<Deque<int, std::allocator<int>, FixedChunks<8>>>(2);
+    }
+
+    SECTION("Nearest end") {
+        Deque<std::string> d;
+        for (int i = 0; i < 10; ++i) {
+            d.push_back(std::to_string(i));
+        }
+        const std::string* last = &d.back();
+        const std::string* first = &d.front();
+
+        // Close to the front: the back elements stay where they are
+        d.insert(d.begin() + 2, 3, "x");
+        REQUIRE(&d.back() == last);
+        d.erase(d.begin() + 1, d.begin() + 3);
+        REQUIRE(&d.back() == last);
+
+        // Close to the back: the front elements stay
+        first = &d.front();
+        d.insert(d.end() - 2, {"y", "z"});
+        REQUIRE(&d.front() == first);
+        d.erase(d.end() - 3);
+        REQUIRE(&d.front() == first);
+
+        REQUIRE(d == Deque<std::string>{"0", "x", "x", "2", "3", "4", "5", "6", "7", "y", "8", "9"});
+        REQUIRE(d.insert(d.begin() + 4, 0, "none") == d.begin() + 4);
+        REQUIRE(d.erase(d.begin() + 4, d.begin() + 4) == d.begin() + 4);
+        REQUIRE(d.size() == 12);
+    }
+
+    SECTION("Empty ranges change nothing") {
+        // Longer than the small string buffer, so a self-move would lose the contents
+        Deque<std::string> d;
+        for (int i = 0; i < 10; ++i) {
+            d.push_back(std::string(40, static_cast<char>('a' + i)));
+        }
+        const Deque<std::string> original = d;
+
+        for (ptrdiff_t pos : {0, 3, 5, 7, 10}) {
+            REQUIRE(d.erase(d.begin() + pos, d.begin() + pos) == d.begin() + pos);
+            REQUIRE(d.insert(d.begin() + pos, 0, "none") == d.begin() + pos);
+            std::vector<std::string> none;
+            REQUIRE(d.insert(d.begin() + pos, none.begin(), none.end()) == d.begin() + pos);
+            REQUIRE(d == original);
+        }
+    }
+
+    SECTION("Throwing copies leave the deque as it was") {
+        Deque<ThrowingCopy, std::allocator<ThrowingCopy>, FixedChunks<4>> d;
+        std::deque<int> true_d;
+        for (int i = 0; i < 50; ++i) {
+            d.emplace_back(i);
+            true_d.push_back(i);
+        }
+        std::vector<ThrowingCopy> values(20, ThrowingCopy(-1));
+
+        // Positions closer to an end than the 20 values, so some are copied into new slots
+        for (size_t pos : {0, 5, 45, 50}) {
+            ThrowingCopy::copies_left = 7;
+            REQUIRE_THROWS_AS(d.insert(d.begin() + pos, values.begin(), values.end()), std::runtime_error);
+            ThrowingCopy::copies_left = 1'000'000;
+            REQUIRE(d.size() == 50);
+            for (size_t i = 0; i < d.size(); ++i) {
+                REQUIRE(d[i].value == true_d[i]);
+            }
+        }
+    }
+}
+
+// The segmented algorithms against the std ones, on ranges starting and ending anywhere
+template <typename D>
+void CheckSegmentedAlgorithms(D& d) {
+    std::mt19937 gen(5);
+    std::vector<int> expected(d.begin(), d.end());
+
+    size_t covered = 0;
+    for (auto segment : std::as_const(d).segments()) {
+        REQUIRE(segment.size > 0);
+        REQUIRE(std::equal(segment.begin(), segment.end(), expected.begin() + static_cast<ptrdiff_t>(covered)));
+        covered += segment.size;
+    }
+    REQUIRE(covered == d.size());
+
+    for (int round = 0; round < 200; ++round) {
+        size_t from = gen() % (d.size() + 1);
+        size_t to = from + gen() % (d.size() - from + 1);
+        auto first = d.begin() + static_cast<ptrdiff_t>(from);
+        auto last = d.begin() + static_cast<ptrdiff_t>(to);
+        auto expected_first = expected.begin() + static_cast<ptrdiff_t>(from);
+        auto expected_last = expected.begin() + static_cast<ptrdiff_t>(to);
+
+        REQUIRE(segmented::Accumulate(first, last, 0LL) == std::accumulate(expected_first, expected_last, 0LL));
+        long long count = 0;
+        segmented::ForEach(first, last, [&count](int) { ++count; });
+        REQUIRE(count == static_cast<long long>(to - from));
+
+        int value = static_cast<int>(gen() % 1000);
+        REQUIRE(segmented::Find(first, last, value) - d.begin() == std::find(expected_first, expected_last, value) - expected.begin());
+
+        std::vector<int> copied(to - from);
+        REQUIRE(segmented::Copy(first, last, copied.begin()) == copied.end());
+        REQUIRE(std::equal(copied.begin(), copied.end(), expected_first));
+
+        // Into another place of the same deque, from the vector copy
+        size_t dest = gen() % (d.size() - copied.size() + 1);
+        REQUIRE(segmented::Copy(copied.begin(), copied.end(), d.begin() + static_cast<ptrdiff_t>(dest)) -
+                d.begin() == static_cast<ptrdiff_t>(dest + copied.size()));
+        std::copy(copied.begin(), copied.end(), expected.begin() + static_cast<ptrdiff_t>(dest));
+
+        if (round % 10 == 0) {
+            segmented::Fill(first, last, round);
+            std::fill(expected_first, expected_last, round);
+        }
+        REQUIRE(std::equal(d.begin(), d.end(), expected.begin(), expected.end()));
+    }
+}
+
+TEST_CASE("Segmented algorithms") {
+    SECTION("Tiny chunks") {
+        Deque<int, std::allocator<int>, FixedChunks<4>> d;
+        for (int i = 0; i < 300; ++i) {
+            d.push_back(i % 1000);
+            d.push_front(i * 7 % 1000);
+        }
+        CheckSegmentedAlgorithms(d);
+    }
+
+    SECTION("Default chunks") {
+        Deque<int> d;
+        for (int i = 0; i < 5000; ++i) {
+            d.push_front(i % 1000);
+        }
+        CheckSegmentedAlgorithms(d);
+
+        // Deque to Deque, the runs of both sides out of step
+        Deque<int> other(6000, 0);
+        auto end = segmented::Copy(d.begin() + 3, d.end(), other.begin() + 500);
+        REQUIRE(end == other.begin() + 5497);
+        REQUIRE(std::equal(d.begin() + 3, d.end(), other.begin() + 500));
+        const Deque<int>& const_other = other;
+        REQUIRE(segmented::Find(const_other.begin(), const_other.end(), -1) == const_other.end());
+        auto nines = [](std::string str, int value) {
+            return value == 999 ? str + "9" : str;
+        };
+        REQUIRE(segmented::Accumulate(d.begin(), d.end(), std::string(), nines) ==
+                std::accumulate(d.begin(), d.end(), std::string(), nines));
+    }
+}
+
+// Counts the bytes it hands out per arena; allocators of different arenas are unequal
+struct Arena {
+    long long bytes = 0;
+    long long blocks = 0;
+};
+
+template <typename T, bool kPropagate>
+struct ArenaAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<kPropagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<kPropagate>;
+    using propagate_on_container_swap = std::bool_constant<kPropagate>;
+
+    Arena* arena;
+
+    explicit ArenaAllocator(Arena* arena) : arena(arena) {
+    }
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U, kPropagate>;
+    };
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U, kPropagate>& other) : arena(other.arena) {
+    }
+
+    T* allocate(size_t count) {
+        arena->bytes += static_cast<long long>(count * sizeof(T));
+        ++arena->blocks;
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* ptr, size_t count) {
+        arena->bytes -= static_cast<long long>(count * sizeof(T));
+        --arena->blocks;
+        std::allocator<T>().deallocate(ptr, count);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U, kPropagate>& other) const {
+        return arena == other.arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U, kPropagate>& other) const {
+        return arena != other.arena;
+    }
+};
+
+TEST_CASE("Allocators") {
+    SECTION("Chunks and the map come from the allocator") {
+        Arena arena;
+        {
+            using Alloc = ArenaAllocator<std::string, false>;
+            Deque<std::string, Alloc, FixedChunks<4>> d{Alloc(&arena)};
+            for (int i = 0; i < 100; ++i) {
+                d.push_back(std::to_string(i));
+                d.push_front(std::to_string(-i));
+            }
+            // 50 chunks and a map
+            REQUIRE(arena.blocks >= 51);
+            REQUIRE(arena.bytes >= static_cast<long long>(200 * sizeof(std::string) + 50 * sizeof(std::string*)));
+
+            d.insert(d.begin() + 3, 10, "x");
+            d.erase(d.begin() + 100, d.end());
+            d.shrink_to_fit();
+            auto copy = d;
+            REQUIRE(copy.get_allocator() == d.get_allocator());
+        }
+        REQUIRE(arena.blocks == 0);
+        REQUIRE(arena.bytes == 0);
+    }
+
+    SECTION("shrink_to_fit of an empty deque frees every chunk") {
+        Arena arena;
+        {
+            using Alloc = ArenaAllocator<int, false>;
+            Deque<int, Alloc, FixedChunks<4>> d{Alloc(&arena)};
+            for (int i = 0; i < 100; ++i) {
+                d.push_back(i);
+                d.push_front(-i);
+            }
+            d.erase(d.begin(), d.end());
+            d.shrink_to_fit();
+            // Only the map is left
+            REQUIRE(arena.blocks == 1);
+
+            d.push_back(1);
+            REQUIRE(d.front() == 1);
+        }
+        REQUIRE(arena.blocks == 0);
+        REQUIRE(arena.bytes == 0);
+    }
+
+    SECTION("Not propagating") {
+        using Alloc = ArenaAllocator<int, false>;
+        Arena first;
+        Arena second;
+        {
+            Deque<int, Alloc> a({1, 2, 3}, Alloc(&first));
+            Deque<int, Alloc> b{Alloc(&second)};
+            b = a;
+            REQUIRE(b.get_allocator() == Alloc(&second));
+            REQUIRE(b == a);
+
+            // The elements are moved into chunks of the second arena
+            Deque<int, Alloc> c(5, 7, Alloc(&first));
+            b = std::move(c);
+            REQUIRE(b.get_allocator() == Alloc(&second));
+            REQUIRE(b == Deque<int, Alloc>(5, 7, Alloc(&first)));
+            REQUIRE(first.blocks > 0);
+            REQUIRE(second.blocks > 0);
+
+            Deque<int, Alloc> d(std::move(a));
+            REQUIRE(d.get_allocator() == Alloc(&first));
+            REQUIRE(a.empty());
+        }
+        REQUIRE(first.blocks == 0);
+        REQUIRE(second.blocks == 0);
+    }
+
+    SECTION("Propagating") {
+        using Alloc = ArenaAllocator<int, true>;
+        Arena first;
+        Arena second;
+        {
+            Deque<int, Alloc> a({1, 2, 3}, Alloc(&first));
+            Deque<int, Alloc> b({4}, Alloc(&second));
+            b = a;
+            REQUIRE(b.get_allocator() == Alloc(&first));
+
+            Deque<int, Alloc> c({5, 6}, Alloc(&second));
+            a.swap(c);
+            REQUIRE(a.get_allocator() == Alloc(&second));
+            REQUIRE(c.get_allocator() == Alloc(&first));
+
+            b = std::move(a);
+            REQUIRE(b.get_allocator() == Alloc(&second));
+            REQUIRE(b == Deque<int, Alloc>({5, 6}, Alloc(&first)));
+        }
+        REQUIRE(first.blocks == 0);
+        REQUIRE(second.blocks == 0);
+    }
+}
+
+// Every value the owner pushes must come out exactly once, through pop or steal
+static void WorkStealingStress(size_t thieves, int64_t count, int pop_every) {
+    WorkStealingDeque<int64_t> d(4);
+    std::vector<std::atomic<int>> seen(static_cast<size_t>(count));
+    std::atomic<bool> done{false};
+    std::atomic<int64_t> stolen{0};
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < thieves; ++t) {
+        threads.emplace_back([&] {
+            while (!done.load(std::memory_order_acquire) || !d.empty()) {
+                if (auto value = d.steal()) {
+                    seen[static_cast<size_t>(*value)].fetch_add(1, std::memory_order_relaxed);
+                    stolen.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    int64_t popped = 0;
+    for (int64_t i = 0; i < count; ++i) {
+        d.push(i);
+        // Popping often empties the deque, so the owner races the thieves for the last element
+        if (i % pop_every == 0) {
+            while (auto value = d.pop()) {
+                seen[static_cast<size_t>(*value)].fetch_add(1, std::memory_order_relaxed);
+                ++popped;
+                if (popped % 3 == 0) {
+                    break;
+                }
+            }
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    while (auto value = d.pop()) {
+        seen[static_cast<size_t>(*value)].fetch_add(1, std::memory_order_relaxed);
+        ++popped;
+    }
+
+    REQUIRE(popped + stolen.load() == count);
+    for (const auto& times : seen) {
+        REQUIRE(times.load() == 1);
+    }
+    REQUIRE(d.empty());
+}
+
+TEST_CASE("Work-stealing deque") {
+    SECTION("Owner pops LIFO, thieves steal FIFO") {
+        WorkStealingDeque<int> d(3);
+        REQUIRE(d.capacity() == 4);
+        REQUIRE(!d.pop());
+        REQUIRE(!d.steal());
+
+        for (int i = 0; i < 100; ++i) {
+            d.push(i);
+        }
+        REQUIRE(d.size() == 100);
+        REQUIRE(d.capacity() == 128);
+        REQUIRE(d.steal() == 0);
+        REQUIRE(d.steal() == 1);
+        REQUIRE(d.pop() == 99);
+        REQUIRE(d.pop() == 98);
+
+        while (d.pop()) {
+        }
+        REQUIRE(d.empty());
+
+        // top and bottom run far past the capacity, the array wraps around without growing
+        for (int i = 0; i < 1000; ++i) {
+            d.push(i);
+            d.push(-i);
+            REQUIRE(d.pop() == -i);
+            REQUIRE(d.steal() == i);
+        }
+        REQUIRE(d.capacity() == 128);
+    }
+
+    SECTION("Concurrent owner and thieves") {
+        WorkStealingStress(1, 200'000, 1'000'000);
+        WorkStealingStress(3, 200'000, 1'000'000);
+        WorkStealingStress(3, 200'000, 7);
+        WorkStealingStress(8, 100'000, 2);
+    }
+}
+
 static void C_A_T_C_H_T_E_S_T_54(); _Pragma( "clang diagnostic push" ) _Pragma( "clang diagnostic ignored \"-Wexit-time-destructors\"" ) _Pragma( "clang diagnostic ignored \"-Wglobal-constructors\"") namespace{ Catch::AutoReg autoRegistrar55( Catch::makeTestInvoker( &C_A_T_C_H_T_E_S_T_54 ), ::Catch::SourceLineInfo( "/home/semyon/Algo/4sem/1CourseContest/deque_tests.cpp", static_cast<std::size_t>( 24 ) ), Catch::StringRef(), Catch::NameAndTags{ "Deque_tests_21" } ); } _Pragma( "clang diagnostic pop" ) static void C_A_T_C_H_T_E_S_T_54() {
     SECTION("Constructors...") {
         Deque<int> d1 = {1, 2, 3, 4, 5};
@@ -144,15 +871,15 @@ static void C_A_T_C_H_T_E_S_T_54(); _Pragma( "clang diagnostic push" ) _Pragma(
         REQUIRE(d == Deque<char>{'a', 'c', 'd', 'g'});
     }
 
-    // SECTION("insert") {
-    //     Deque<float> dd(5, 5.);
-    //     dd.insert(dd.begin() + 1, 7.0);
-    //     REQUIRE(dd == Deque<float>{5.0, 7.0, 5.0, 5.0, 5.0, 5.0});
-    //     dd.insert(dd.begin(), {3, 4.0});
-    //     REQUIRE(dd == Deque<float>{3.0, 4.0, 5.0, 7.0, 5.0, 5.0, 5.0, 5.0});
-    //     dd.insert(dd.begin() + 2, {4, 5.0});
-    //     REQUIRE(dd == Deque<float>{3.0, 4.0, 4.0, 5.0, 5.0, 7.0, 5.0, 5.0, 5.0, 5.0});
-    // }
+    SECTION("insert") {
+        Deque<float> dd(5, 5.);
+        dd.insert(dd.begin() + 1, 7.0);
+        REQUIRE(dd == Deque<float>{5.0, 7.0, 5.0, 5.0, 5.0, 5.0});
+        dd.insert(dd.begin(), {3, 4.0});
+        REQUIRE(dd == Deque<float>{3.0, 4.0, 5.0, 7.0, 5.0, 5.0, 5.0, 5.0});
+        dd.insert(dd.begin() + 2, {4, 5.0});
+        REQUIRE(dd == Deque<float>{3.0, 4.0, 4.0, 5.0, 5.0, 7.0, 5.0, 5.0, 5.0, 5.0});
+    }
 
     SECTION("auto &x : Deque") {
         Deque<float> dd(5, 5.);
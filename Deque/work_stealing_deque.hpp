@@ -0,0 +1,159 @@
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+// Chase-Lev work-stealing deque, with the memory orderings of Le, Pop, Cohen and
+// Zappa Nardelli, "Correct and Efficient Work-Stealing for Weak Memory Models".
+//
+// One thread, the owner, calls push and pop at the bottom like a stack. Any other
+// thread may call steal, which takes the oldest element from the top. Neither side
+// locks: the owner and the thieves only compete, through a CAS on top_, for the
+// last element.
+//
+// Elements live in a circular array indexed by the ever growing top_ and bottom_.
+// A full array is replaced by one twice as large. A thief may still be reading the
+// old one, so it is retired, not freed, until the deque is destroyed; all retired
+// arrays together are smaller than the current one.
+//
+// A thief reads its element before its CAS tells it whether the element is really
+// its own, and the owner may overwrite that slot meanwhile. That is why slots are
+// atomics and T must be trivially copyable, e.g. a pointer to a task.
+template <typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque copies elements a thief may lose");
+
+public:
+    static const size_t kDefaultCapacity = 1024;
+
+    explicit WorkStealingDeque(size_t capacity = kDefaultCapacity) {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        arrays_.push_back(std::make_unique<Array>(rounded));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only
+    void push(T value) {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(array->mask)) {
+            array = Grow(array, top, bottom);
+        }
+
+        array->Put(bottom, value);
+        // The element must be visible before the thief that sees the new bottom_ reads it
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only: the newest element, or nothing if the deque is empty
+    std::optional<T> pop() {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        // Orders the store of bottom_ before the load of top_, against the thieves'
+        // load of top_ before bottom_
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+
+        T value = array->Get(bottom);
+        if (top == bottom) {
+            // The last element: whoever moves top_ first gets it
+            bool won = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return value;
+    }
+
+    // Any thread: the oldest element, or nothing if the deque is empty or another
+    // thread took that element first. Thieves usually retry elsewhere in either case.
+    std::optional<T> steal() {
+        int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return std::nullopt;
+        }
+
+        // Acquire pairs with the release store in Grow, so the copied slots are visible
+        Array* array = array_.load(std::memory_order_acquire);
+        T value = array->Get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    // Exact only when no other thread is using the deque
+    size_t size() const {
+        int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        int64_t top = top_.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return array_.load(std::memory_order_relaxed)->mask + 1;
+    }
+
+private:
+    struct Array {
+        explicit Array(size_t capacity) : mask(capacity - 1), slots(new std::atomic<T>[capacity]) {
+        }
+
+        T Get(int64_t idx) const {
+            return slots[static_cast<size_t>(idx) & mask].load(std::memory_order_relaxed);
+        }
+
+        void Put(int64_t idx, T value) {
+            slots[static_cast<size_t>(idx) & mask].store(value, std::memory_order_relaxed);
+        }
+
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+    };
+
+    // Copies the elements from top to bottom into an array twice as large and publishes it
+    Array* Grow(Array* array, int64_t top, int64_t bottom) {
+        arrays_.push_back(std::make_unique<Array>(2 * (array->mask + 1)));
+        Array* grown = arrays_.back().get();
+        for (int64_t idx = top; idx < bottom; ++idx) {
+            grown->Put(idx, array->Get(idx));
+        }
+        array_.store(grown, std::memory_order_release);
+        return grown;
+    }
+
+    // top_ and bottom_ are written by different threads, keep them on separate cache lines
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+    alignas(64) std::atomic<Array*> array_{nullptr};
+    // Every array ever used, the current one last; touched by the owner only
+    std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+#endif
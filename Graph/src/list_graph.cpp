@@ -2,38 +2,53 @@
 
 
 ListGraph::ListGraph(const size_t n_vertices) {
+    graph_.Reserve(n_vertices, 0);
     for (size_t i = 0; i < n_vertices; ++i)
-        graph_.push_back(std::vector<size_t>());
+        graph_.AppendEmptyRow();
 }
 
-ListGraph::ListGraph(const IGraph* graph) : ListGraph(graph->VerticesCount()) {
+ListGraph::ListGraph(const IGraph* graph) {
+    // Whole rows appended in order leave no slack between them
+    graph_.Reserve(graph->VerticesCount(), 0);
     std::vector<size_t> vertices;
     for (size_t from = 0; from < graph->VerticesCount(); ++from) {
         graph->GetNextVertices(from, vertices);
-        for (size_t to = 0; to < vertices.size(); ++to)
-            AddEdge(from, vertices[to]);
-            
+        graph_.AppendRow(vertices.begin(), vertices.end());
+
         vertices.clear();
     }
 }
 
+ListGraph::ListGraph(const size_t n_vertices, std::span<const std::pair<size_t, size_t>> edges) {
+    std::vector<size_t> counts(n_vertices);
+    for (const auto& [from, to] : edges)
+        ++counts[from];
+
+    graph_ = JaggedVector<size_t>::FromCounts(counts);
+    for (const auto& [from, to] : edges)
+        graph_.PushBackToRow(from, to);
+}
+
 void ListGraph::AddEdge(size_t from, size_t to) {
-    graph_[from].push_back(to);
+    graph_.PushBackToRow(from, to);
 }
 
 size_t ListGraph::VerticesCount() const noexcept {
-    return graph_.size();
+    return graph_.Size();
 }
 
 void ListGraph::GetNextVertices(size_t vertex, std::vector<size_t>& vertices) const noexcept {
-    for (size_t i = 0; i < graph_[vertex].size(); ++i) {
-            vertices.push_back(graph_[vertex][i]);
-    }
+    std::span<const size_t> next = graph_[vertex];
+    vertices.insert(vertices.end(), next.begin(), next.end());
 }
 
 void ListGraph::GetPrevVertices(size_t vertex, std::vector<size_t>& vertices) const noexcept {
-    for (size_t from = 0; from < graph_.size(); ++from)
-        for (size_t i = 0; i < graph_[from].size(); ++i)
-            if (graph_[from][i] == vertex) 
+    for (size_t from = 0; from < graph_.Size(); ++from)
+        for (size_t to : graph_[from])
+            if (to == vertex)
                 vertices.push_back(from);
 }
+
+void ListGraph::ShrinkToFit() {
+    graph_.ShrinkToFit();
+}
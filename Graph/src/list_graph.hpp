@@ -1,6 +1,10 @@
 #pragma once
 
+#include <span>
+#include <utility>
+
 #include "igraph.hpp"
+#include "../../Vector/jagged_vector.hpp"
 
 
 class ListGraph : public IGraph {
@@ -8,6 +12,9 @@ class ListGraph : public IGraph {
 public:
     ListGraph(const size_t n_vertices = 0);
     ListGraph(const IGraph* graph);
+    // All edges known up front: a counting pass sizes every row exactly, so no row
+    // is moved and the buffer has no slack
+    ListGraph(const size_t n_vertices, std::span<const std::pair<size_t, size_t>> edges);
 
     ~ListGraph() = default;
 
@@ -16,10 +23,15 @@ public:
     void GetNextVertices(size_t vertex, std::vector<size_t>& vertices) const noexcept override;
     void GetPrevVertices(size_t vertex, std::vector<size_t>& vertices) const noexcept override;
 
+    // Packs the rows after a series of AddEdge calls, which move rows that outgrow
+    // their room and can leave up to half of the buffer unused
+    void ShrinkToFit();
+
     ListGraph(const ListGraph& ) = delete;
     ListGraph& operator=(const ListGraph& ) = delete;
 
 private:
-    std::vector<std::vector<size_t>> graph_;
+    // Row i holds the heads of the edges out of i, all rows in one buffer
+    JaggedVector<size_t> graph_;
 
 };
\ No newline at end of file
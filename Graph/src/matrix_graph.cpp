@@ -3,7 +3,7 @@
 
 MatrixGraph::MatrixGraph(const size_t n_vertices) {
     for (size_t i = 0; i < n_vertices; ++i)
-        matrix_.push_back(std::vector<bool>(n_vertices, false));
+        matrix_.push_back(BitVector(n_vertices));
 }
 
 MatrixGraph::MatrixGraph(const IGraph* graph) : MatrixGraph(graph->VerticesCount()) {
@@ -18,7 +18,7 @@ MatrixGraph::MatrixGraph(const IGraph* graph) : MatrixGraph(graph->VerticesCount
 }
 
 void MatrixGraph::AddEdge(size_t from, size_t to) {
-    matrix_[from][to] = true;
+    matrix_[from].Set(to);
 }
 
 size_t MatrixGraph::VerticesCount() const noexcept {
@@ -26,15 +26,12 @@ size_t MatrixGraph::VerticesCount() const noexcept {
 }
 
 void MatrixGraph::GetNextVertices(size_t vertex, std::vector<size_t>& vertices) const noexcept {
-    for (size_t i = 0; i < matrix_.size(); ++i) {
-        if (matrix_[vertex][i])
-            vertices.push_back(i);
-    }
+    matrix_[vertex].ForEachSet([&vertices](size_t to) { vertices.push_back(to); });
 }
 
 void MatrixGraph::GetPrevVertices(size_t vertex, std::vector<size_t>& vertices) const noexcept {
     for (size_t i = 0; i < matrix_.size(); ++i) {
-        if (matrix_[i][vertex])
+        if (matrix_[i].Test(vertex))
             vertices.push_back(i);
     } 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "igraph.hpp"
+#include "../../Vector/bit_vector.hpp"
 
 
 class MatrixGraph : public IGraph {
@@ -20,6 +21,7 @@ public:
     MatrixGraph& operator=(const MatrixGraph& ) = delete;
 
 private:
-    std::vector<std::vector<bool>> matrix_;
+    // Row i holds the heads of the edges out of i, 64 vertices per word
+    std::vector<BitVector> matrix_;
 
 };
\ No newline at end of file
@@ -87,4 +87,23 @@ TEST_CASE("Stress test") {
       }
     }
   }
-}
\ No newline at end of file
+}
+
+TEST_CASE("ListGraph construction") {
+  for (size_t v = 2; v <= 256; v *= 2) {
+    const auto edges = Generate(v, v * v / 4);
+    const std::vector<std::pair<size_t, size_t>> edge_list(edges.begin(), edges.end());
+
+    std::unique_ptr<IGraph> counted = std::make_unique<ListGraph>(v, edge_list);
+    REQUIRE(counted->VerticesCount() == v);
+    REQUIRE(GetEdgesSet(counted) == edges);
+
+    auto added = std::make_unique<ListGraph>(v);
+    for (const auto& [from, to] : edges) {
+      added->AddEdge(from, to);
+    }
+    added->ShrinkToFit();
+    std::unique_ptr<IGraph> shrunk = std::move(added);
+    REQUIRE(GetEdgesSet(shrunk) == edges);
+  }
+}
@@ -46,6 +46,16 @@ public:
 
     void deallocate(T*, size_t) {}
 
+    template <typename U>
+    bool operator==(const StackAllocator<U, N>& other) const {
+        return storage_ == other.storage_;
+    }
+
+    template <typename U>
+    bool operator!=(const StackAllocator<U, N>& other) const {
+        return !(*this == other);
+    }
+
     template <typename U>
     struct rebind {
         using other = StackAllocator<U, N>;
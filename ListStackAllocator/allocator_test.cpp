@@ -13,7 +13,9 @@
 #include <cassert>
 #include <sys/resource.h>
 
-#include "StackAllocator.hpp"
+#include "ListStackAllocator.hpp"
+#include "../Vector/vector.hpp"
+#include "../Deque/deque.hpp"
 //#include "list.h"
 
 //template<typename T, typename Alloc = std::allocator<T>>
@@ -409,6 +411,180 @@ void TestWhimsicalAllocator() {
     }
 }
 
+template <typename Alloc = std::allocator<int>>
+void BasicVectorTest(Alloc alloc = Alloc()) {
+    Vector<int, Alloc> v(alloc);
+
+    assert(v.Size() == 0);
+
+    for (int i = 1; i <= 5; ++i) {
+        v.PushBack(i);
+    }
+    std::reverse(v.begin(), v.end());
+    // now v is 5 4 3 2 1
+
+    std::string s;
+    for (int x: v) {
+        s += std::to_string(x);
+    }
+    assert(s == "54321");
+
+    const auto copy = v;
+    v.PopBack();
+    v.Resize(7, 9);
+    v.ShrinkToFit();
+    assert(v.Size() == 7);
+    assert(v.Capacity() == 7);
+
+    s.clear();
+    for (int x: v) {
+        s += std::to_string(x);
+    }
+    assert(s == "5432999");
+
+    s.clear();
+    for (int x: copy) {
+        s += std::to_string(x);
+    }
+    assert(s == "54321");
+
+    Vector<int, Alloc> moved(std::move(v));
+    assert(moved.Size() == 7);
+    assert(v.Size() == 0);
+
+    v = copy;
+    assert(v.Size() == 5);
+    assert(v.Back() == 1);
+}
+
+void TestVectorWhimsicalAllocator() {
+    {
+        Vector<int, WhimsicalAllocator<int, true, true>> v;
+
+        v.PushBack(1);
+        v.PushBack(2);
+
+        auto copy = v;
+        assert(copy.GetAllocator() != v.GetAllocator());
+
+        v = copy;
+        assert(copy.GetAllocator() == v.GetAllocator());
+    }
+    {
+        Vector<int, WhimsicalAllocator<int, false, false>> v;
+
+        v.PushBack(1);
+        v.PushBack(2);
+
+        auto copy = v;
+        assert(copy.GetAllocator() == v.GetAllocator());
+
+        v = copy;
+        assert(copy.GetAllocator() == v.GetAllocator());
+    }
+    {
+        Vector<int, WhimsicalAllocator<int, true, false>> v;
+
+        v.PushBack(1);
+        v.PushBack(2);
+
+        auto copy = v;
+        assert(copy.GetAllocator() != v.GetAllocator());
+
+        v = copy;
+        assert(copy.GetAllocator() != v.GetAllocator());
+        assert(v.Size() == 2 && v[1] == 2);
+    }
+}
+
+template <typename Alloc = std::allocator<int>>
+void BasicDequeTest(Alloc alloc = Alloc()) {
+    Deque<int, Alloc> d(alloc);
+
+    assert(d.size() == 0);
+
+    for (int i = 1; i <= 5; ++i) {
+        d.push_back(i);
+        d.push_front(-i);
+    }
+    // now d is -5 -4 -3 -2 -1 1 2 3 4 5
+    assert(d.front() == -5 && d.back() == 5);
+
+    const auto copy = d;
+    d.insert(d.begin() + 5, 3, 0);
+    d.erase(d.begin(), d.begin() + 4);
+    d.pop_back();
+
+    std::string s;
+    for (int x: d) {
+        s += std::to_string(x);
+    }
+    assert(s == "-10001234");
+
+    s.clear();
+    for (int x: copy) {
+        s += std::to_string(x);
+    }
+    assert(s == "-5-4-3-2-112345");
+
+    Deque<int, Alloc> moved(std::move(d));
+    assert(moved.size() == 8);
+    assert(d.size() == 0);
+
+    d = copy;
+    assert(d.size() == 10);
+    assert(d.back() == 5);
+    d.shrink_to_fit();
+    assert(d[5] == 1);
+}
+
+void TestDequeWhimsicalAllocator() {
+    {
+        Deque<int, WhimsicalAllocator<int, true, true>> d;
+
+        d.push_back(1);
+        d.push_front(2);
+
+        auto copy = d;
+        assert(copy.get_allocator() != d.get_allocator());
+
+        d = copy;
+        assert(copy.get_allocator() == d.get_allocator());
+    }
+    {
+        Deque<int, WhimsicalAllocator<int, false, false>> d;
+
+        d.push_back(1);
+        d.push_front(2);
+
+        auto copy = d;
+        assert(copy.get_allocator() == d.get_allocator());
+
+        d = copy;
+        assert(copy.get_allocator() == d.get_allocator());
+    }
+    {
+        Deque<int, WhimsicalAllocator<int, true, false>> d;
+
+        d.push_back(1);
+        d.push_front(2);
+
+        auto copy = d;
+        assert(copy.get_allocator() != d.get_allocator());
+
+        d = copy;
+        assert(copy.get_allocator() != d.get_allocator());
+        assert(d.size() == 2 && d[0] == 2);
+
+        // Move assignment propagates, as the std::allocator base says
+        Deque<int, WhimsicalAllocator<int, true, false>> other;
+        other.push_back(3);
+        d = std::move(other);
+        assert(d.get_allocator() == other.get_allocator());
+        assert(d.size() == 1 && d[0] == 3);
+    }
+}
+
 template <class List>
 int ListPerformanceTest(List&& l) {
     using namespace std::chrono;
@@ -540,6 +716,116 @@ void TestPerformance() {
 }
 
 
+// Lots of short-lived vectors, each growing from scratch as it does while serving a request
+template <typename Alloc>
+int VectorPerformanceTest(Alloc alloc) {
+    using namespace std::chrono;
+
+    auto start = high_resolution_clock::now();
+
+    long long checksum = 0;
+    for (int i = 0; i < 1'000'000; ++i) {
+        Vector<int, Alloc> v(alloc);
+        for (int j = 0; j < 12; ++j) {
+            v.PushBack(i + j);
+        }
+        checksum += v.Back();
+    }
+
+    assert(checksum == 500'010'500'000);
+
+    auto finish = high_resolution_clock::now();
+    return duration_cast<milliseconds>(finish - start).count();
+}
+
+void TestVectorPerformance() {
+    std::ostringstream oss_first;
+    std::ostringstream oss_second;
+
+    double mean_first = 0.0;
+    double mean_second = 0.0;
+
+    for (int i = 0; i < 3; ++i) {
+        int first = VectorPerformanceTest(std::allocator<int>());
+        mean_first += first;
+        oss_first << first << " ";
+
+        StackStorage<STORAGE_SIZE> storage;
+        StackAllocator<int, STORAGE_SIZE> alloc(storage);
+        int second = VectorPerformanceTest(alloc);
+        mean_second += second;
+        oss_second << second << " ";
+    }
+
+    mean_first /= 3;
+    mean_second /= 3;
+
+    std::cerr << " Results with std::allocator: " << oss_first.str()
+            << " ms, results with StackAllocator: " << oss_second.str() << " ms " << std::endl;
+
+    if (mean_first * 0.9 < mean_second) {
+        throw std::runtime_error("StackAllocator expected to be at least 10\% faster than std::allocator for Vector, but mean time were "
+                + std::to_string(mean_second) + " ms comparing with " + std::to_string(mean_first) + " :((( ...\n");
+    }
+}
+
+// Lots of short-lived deques used as queues. Small chunks, so most of the time goes to
+// allocating chunks and growing the map.
+template <typename Alloc>
+int DequePerformanceTest(Alloc alloc) {
+    using namespace std::chrono;
+
+    auto start = high_resolution_clock::now();
+
+    long long checksum = 0;
+    for (int i = 0; i < 100'000; ++i) {
+        Deque<int, Alloc, FixedChunks<16>> d(alloc);
+        for (int j = 0; j < 64; ++j) {
+            d.push_back(i + j);
+            d.push_front(j);
+        }
+        for (int j = 0; j < 32; ++j) {
+            d.pop_front();
+        }
+        checksum += d.front() + d.back();
+    }
+
+    assert(checksum == 5'009'350'000);
+
+    auto finish = high_resolution_clock::now();
+    return duration_cast<milliseconds>(finish - start).count();
+}
+
+void TestDequePerformance() {
+    std::ostringstream oss_first;
+    std::ostringstream oss_second;
+
+    double mean_first = 0.0;
+    double mean_second = 0.0;
+
+    for (int i = 0; i < 3; ++i) {
+        int first = DequePerformanceTest(std::allocator<int>());
+        mean_first += first;
+        oss_first << first << " ";
+
+        StackStorage<STORAGE_SIZE> storage;
+        StackAllocator<int, STORAGE_SIZE> alloc(storage);
+        int second = DequePerformanceTest(alloc);
+        mean_second += second;
+        oss_second << second << " ";
+    }
+
+    mean_first /= 3;
+    mean_second /= 3;
+
+    std::cerr << " Results with std::allocator: " << oss_first.str()
+            << " ms, results with StackAllocator: " << oss_second.str() << " ms " << std::endl;
+
+    if (mean_first * 0.9 < mean_second) {
+        throw std::runtime_error("StackAllocator expected to be at least 10\% faster than std::allocator for Deque, but mean time were "
+                + std::to_string(mean_second) + " ms comparing with " + std::to_string(mean_first) + " :((( ...\n");
+    }
+}
 
 int main() {
 
@@ -632,6 +918,36 @@ int main() {
 
     TestPerformance<List>();
 
+    BasicVectorTest<>();
+
+    {
+        StackStorage<200'000> storage;
+        StackAllocator<int, 200'000> alloc(storage);
+
+        BasicVectorTest<StackAllocator<int, 200'000>>(alloc);
+    }
+
+    TestVectorWhimsicalAllocator();
+
+    std::cerr << "Test 8 (Vector with StackAllocator) passed. Now let's test performance of Vector." << std::endl;
+
+    TestVectorPerformance();
+
+    BasicDequeTest<>();
+
+    {
+        StackStorage<200'000> storage;
+        StackAllocator<int, 200'000> alloc(storage);
+
+        BasicDequeTest<StackAllocator<int, 200'000>>(alloc);
+    }
+
+    TestDequeWhimsicalAllocator();
+
+    std::cerr << "Test 9 (Deque with StackAllocator) passed. Now let's test performance of Deque." << std::endl;
+
+    TestDequePerformance();
+
     std::cerr << "Tests passed, my sweetheart!" << std::endl;
 
     if (std::is_assignable_v<List<int>, std::list<int>> || std::is_assignable_v<std::list<int>, List<int>>) {
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "vector.hpp"
+
+// Allocator that starts every block at a multiple of Alignment (and of alignof(T)),
+// e.g. on a cache line for per-thread slots or for aligned SIMD loads.
+// With HugePages blocks of 2 MB and more are aligned and sized to whole 2 MB pages
+// and marked for transparent huge pages, which saves TLB misses on big buffers.
+template <typename T, size_t Alignment = 64, bool HugePages = false>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    static_assert(Alignment > 0 && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+    static constexpr size_t kAlignment = std::max(Alignment, alignof(T));
+    static constexpr size_t kHugePageSize = 2 << 20;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, HugePages>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, HugePages>&) {}
+
+    T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (IsHuge(bytes)) {
+            void* ptr = ::operator new(HugeBytes(bytes), std::align_val_t(kHugePageSize));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            madvise(ptr, HugeBytes(bytes), MADV_HUGEPAGE);
+#endif
+            return static_cast<T*>(ptr);
+        }
+        return static_cast<T*>(::operator new(bytes, std::align_val_t(kAlignment)));
+    }
+
+    void deallocate(T* ptr, size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (IsHuge(bytes)) {
+            ::operator delete(ptr, HugeBytes(bytes), std::align_val_t(kHugePageSize));
+            return;
+        }
+        ::operator delete(ptr, bytes, std::align_val_t(kAlignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment, HugePages>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment, HugePages>&) const {
+        return false;
+    }
+
+private:
+    static bool IsHuge(size_t bytes) {
+        return HugePages && bytes >= kHugePageSize;
+    }
+
+    static size_t HugeBytes(size_t bytes) {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+};
+
+// Vector whose data starts on a cache line, or on any other power of two
+template <typename T, size_t Alignment = 64>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>>;
@@ -0,0 +1,715 @@
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cassert>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "vector.hpp"
+#include "parallel_vector.hpp"
+#include "malloc_allocator.hpp"
+#include "huge_vector.hpp"
+#include "simd_algorithms.hpp"
+#include "mapped_vector.hpp"
+#include "aligned_allocator.hpp"
+#include "concurrent_vector.hpp"
+#include "soa_vector.hpp"
+#include "persistent_vector.hpp"
+#include "bit_vector.hpp"
+#include "compressed_vector.hpp"
+#include "jagged_vector.hpp"
+
+// Same layout as int, but the user-provided copy forces Vector to relocate element by element
+struct ElementWiseInt {
+    int value = 0;
+
+    ElementWiseInt(int value = 0) : value(value) {}
+    ElementWiseInt(const ElementWiseInt& other) : value(other.value) {}
+    ElementWiseInt& operator=(const ElementWiseInt& other) {
+        value = other.value;
+        return *this;
+    }
+};
+
+// Best of a few runs, so that page faults of the first touch don't dominate
+template <typename Func>
+long long MeasureMs(Func&& func, int runs = 3) {
+    using namespace std::chrono;
+
+    long long best = -1;
+    for (int i = 0; i < runs; ++i) {
+        auto start = high_resolution_clock::now();
+        func();
+        auto finish = high_resolution_clock::now();
+        long long elapsed = duration_cast<milliseconds>(finish - start).count();
+        if (best < 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+template <typename Vec>
+long long GrowthTest(size_t count) {
+    return MeasureMs([count] {
+        Vec v;
+        for (size_t i = 0; i < count; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        v.Resize(count / 2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == count / 2);
+    });
+}
+
+template <typename Vec>
+long long CopyTest(size_t count, int rounds) {
+    Vec v(count, 1);
+    return MeasureMs([&v, rounds] {
+        for (int i = 0; i < rounds; ++i) {
+            Vec copy = v;
+            assert(copy.Size() == v.Size());
+        }
+    });
+}
+
+void BenchmarkRelocation() {
+    const size_t kCount = 50'000'000;
+    const size_t kCopyCount = 10'000'000;
+    const int kCopyRounds = 20;
+
+    std::cerr << "Relocation (PushBack of " << kCount << " elements, then ShrinkToFit):" << std::endl;
+    std::cerr << "  element-wise: " << GrowthTest<Vector<ElementWiseInt>>(kCount) << " ms" << std::endl;
+    std::cerr << "  memcpy:       " << GrowthTest<Vector<int>>(kCount) << " ms" << std::endl;
+    std::cerr << "  realloc:      " << GrowthTest<Vector<int, MallocAllocator<int>>>(kCount) << " ms" << std::endl;
+
+    std::cerr << "Copy constructor (" << kCopyRounds << " copies of " << kCopyCount << " elements):" << std::endl;
+    std::cerr << "  element-wise: " << CopyTest<Vector<ElementWiseInt>>(kCopyCount, kCopyRounds) << " ms" << std::endl;
+    std::cerr << "  memcpy:       " << CopyTest<Vector<int>>(kCopyCount, kCopyRounds) << " ms" << std::endl;
+}
+
+// Runs func in a child process so that its peak RSS isn't mixed with other runs
+template <typename Func>
+long PeakRssMb(Func&& func) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        func();
+        _exit(0);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    wait4(pid, &status, 0, &usage);
+    return usage.ru_maxrss / 1024;
+}
+
+template <typename Vec>
+void HugeGrowthTest(const char* name, size_t count) {
+    long peak = PeakRssMb([count, name] {
+        using namespace std::chrono;
+
+        long long longest_stall = 0;
+        // Growths that kept the address: realloc or mremap extended the block in place
+        size_t growths = 0;
+        size_t in_place = 0;
+        auto start = high_resolution_clock::now();
+
+        Vec v;
+        for (size_t i = 0; i < count; ++i) {
+            if (v.Size() == v.Capacity()) {
+                const auto* data = v.Data();
+                auto stall_start = high_resolution_clock::now();
+                v.PushBack(i);
+                auto stall = duration_cast<microseconds>(high_resolution_clock::now() - stall_start).count();
+                longest_stall = std::max(longest_stall, static_cast<long long>(stall));
+                ++growths;
+                in_place += data != nullptr && v.Data() == data;
+            } else {
+                v.PushBack(i);
+            }
+        }
+
+        auto total = duration_cast<milliseconds>(high_resolution_clock::now() - start).count();
+        std::cerr << "  " << name << total << " ms, longest growth " << longest_stall / 1000.0 << " ms, "
+                  << in_place << "/" << growths << " growths in place";
+    });
+    std::cerr << ", peak RSS " << peak << " MB" << std::endl;
+}
+
+void BenchmarkHugeGrowth() {
+    const size_t kCount = 48'000'000;
+
+    std::cerr << "Huge growth (PushBack of " << kCount << " uint64_t, " << kCount * 8 / (1 << 20) << " MB):" << std::endl;
+    HugeGrowthTest<Vector<uint64_t>>("std::allocator: ", kCount);
+    HugeGrowthTest<Vector<uint64_t, MallocAllocator<uint64_t>>>("realloc:        ", kCount);
+    HugeGrowthTest<HugeVector<uint64_t>>("mremap:         ", kCount);
+}
+
+template <typename Growth>
+void GrowthPolicyTest(const char* name, size_t count) {
+    using Vec = Vector<uint64_t, std::allocator<uint64_t>, CountingGrowth<Growth>>;
+
+    size_t reallocations = 0;
+    size_t bytes_moved = 0;
+    size_t capacity = 0;
+    long long ms = MeasureMs([&] {
+        Vec v;
+        for (size_t i = 0; i < count; ++i) {
+            v.PushBack(i);
+        }
+        reallocations = v.GetGrowthPolicy().Reallocations();
+        bytes_moved = v.GetGrowthPolicy().BytesMoved();
+        capacity = v.Capacity();
+    });
+
+    std::cerr << "  " << name << ms << " ms, " << reallocations << " reallocations, "
+              << bytes_moved / (1 << 20) << " MB moved, "
+              << (capacity - count) * 100 / capacity << "% of capacity unused" << std::endl;
+}
+
+void BenchmarkGrowthPolicies() {
+    const size_t kCount = 20'000'000;
+
+    std::cerr << "Growth policies (PushBack of " << kCount << " uint64_t):" << std::endl;
+    GrowthPolicyTest<DoublingGrowth>("2x:                ", kCount);
+    GrowthPolicyTest<OneAndHalfGrowth>("1.5x:              ", kCount);
+    GrowthPolicyTest<PageRoundedGrowth<>>("page rounded:      ", kCount);
+    GrowthPolicyTest<SizeClassGrowth<>>("size class:        ", kCount);
+    GrowthPolicyTest<SizeClassGrowth<OneAndHalfGrowth>>("1.5x + size class: ", kCount);
+}
+
+// A 64-byte record, copied field by field
+struct Record {
+    uint64_t fields[8] = {};
+
+    Record() = default;
+    Record(const Record& other) {
+        for (int i = 0; i < 8; ++i)
+            fields[i] = other.fields[i];
+    }
+    Record& operator=(const Record&) = default;
+};
+
+void BenchmarkParallel() {
+    const size_t kCount = 4'000'000;
+    const Record kRecord;
+
+    std::cerr << "Parallel construction (" << kCount << " records, " << kCount * sizeof(Record) / (1 << 20)
+              << " MB, " << ThreadPool::HardwareThreads() << " hardware threads):" << std::endl;
+    const Vector<Record> source(kCount);
+    for (size_t threads : {1, 2, 4, 8}) {
+        const ParallelExecution exec{1 << 16, threads};
+        long long fill = MeasureMs([&] {
+            const auto v = MakeParallel(kCount, kRecord, exec);
+        });
+        long long copy = MeasureMs([&] {
+            const auto v = MakeParallel(source, exec);
+        });
+        std::cerr << "  " << threads << " threads: fill " << fill << " ms, copy " << copy << " ms" << std::endl;
+    }
+}
+
+// Result sink, so that the compiler can't drop the measured calls
+volatile double simd_sink = 0;
+
+template <typename T>
+void SimdTest(const char* type_name) {
+    const size_t kCount = 1 << 20;
+    const int kRounds = 200;
+    const double kGigabytes = static_cast<double>(kCount * sizeof(T)) * kRounds / 1e9;
+
+    Vector<T> v(kCount, static_cast<T>(1));
+    Vector<T> other = v;
+    const char* level_names[] = {"scalar", "SSE2  ", "AVX2  "};
+
+    std::cerr << "  " << type_name << ":" << std::endl;
+    for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2}) {
+        if (level > BestSimdLevel())
+            break;
+
+        auto throughput = [&](auto&& func) {
+            long long ms = MeasureMs([&] {
+                for (int i = 0; i < kRounds; ++i)
+                    func();
+            });
+            return kGigabytes / (static_cast<double>(std::max(ms, 1LL)) / 1000);
+        };
+        double fill = throughput([&] { simd::Fill(v, static_cast<T>(1), level); });
+        double find = throughput([&] { simd_sink = static_cast<double>(simd::Find(v, static_cast<T>(2), level) - v.begin()); });
+        double count = throughput([&] { simd_sink = static_cast<double>(simd::Count(v, static_cast<T>(1), level)); });
+        double sum = throughput([&] { simd_sink = static_cast<double>(simd::Sum(v, level)); });
+        double min_max = throughput([&] { simd_sink = static_cast<double>(simd::MinMax(v, level).second); });
+        double equal = throughput([&] { simd_sink = simd::Equal(v, other, level); });
+
+        std::cerr << "    " << level_names[static_cast<int>(level)] << " GB/s: fill " << fill << ", find " << find
+                  << ", count " << count << ", sum " << sum << ", minmax " << min_max << ", equal " << equal << std::endl;
+    }
+}
+
+void BenchmarkSimd() {
+    std::cerr << "SIMD algorithms (" << (1 << 20) << " elements, in cache):" << std::endl;
+    SimdTest<int32_t>("int32_t");
+    SimdTest<float>("float");
+    SimdTest<double>("double");
+}
+
+void BenchmarkMapped() {
+    const size_t kCount = 32'000'000;
+    const std::string path = "/tmp/bench_vector_mapped";
+
+    std::cerr << "Loading " << kCount * sizeof(uint64_t) / (1 << 20) << " MB from a file (page cache warm):" << std::endl;
+    long long write = MeasureMs([&] {
+        unlink(path.c_str());
+        MappedVector<uint64_t> v(path);
+        v.Reserve(kCount);
+        for (size_t i = 0; i < kCount; ++i)
+            v.PushBack(i);
+    }, 1);
+    std::cerr << "  write with MappedVector: " << write << " ms" << std::endl;
+
+    long long read_all = MeasureMs([&] {
+        Vector<uint64_t> v;
+        v.ResizeUninitialized(kCount);
+        int fd = open(path.c_str(), O_RDONLY);
+        size_t done = 0;
+        while (done < kCount * sizeof(uint64_t)) {
+            ssize_t got = read(fd, reinterpret_cast<char*>(v.Data()) + done, kCount * sizeof(uint64_t) - done);
+            if (got <= 0)
+                break;
+            done += static_cast<size_t>(got);
+        }
+        close(fd);
+        simd_sink = static_cast<double>(v.Back());
+    });
+    std::cerr << "  read() into Vector:      " << read_all << " ms" << std::endl;
+
+    long long open_only = MeasureMs([&] {
+        MappedVector<uint64_t> v(path, MappedVector<uint64_t>::Mode::kReadOnly);
+        simd_sink = static_cast<double>(v.Back());
+    });
+    std::cerr << "  open MappedVector:       " << open_only << " ms" << std::endl;
+
+    long long open_and_scan = MeasureMs([&] {
+        MappedVector<uint64_t> v(path, MappedVector<uint64_t>::Mode::kReadOnly);
+        uint64_t sum = 0;
+        for (uint64_t x : v)
+            sum += x;
+        simd_sink = static_cast<double>(sum);
+    });
+    std::cerr << "  open and scan all:       " << open_and_scan << " ms" << std::endl;
+    unlink(path.c_str());
+}
+
+void BenchmarkAlignment() {
+    const size_t kCount = 4096;
+    const int kRounds = 200'000;
+    const double kGigabytes = static_cast<double>(kCount * sizeof(float)) * kRounds / 1e9;
+
+    std::cerr << "Aligned loads (AVX2 Sum over " << kCount << " floats, in L1):" << std::endl;
+    AlignedVector<float> v(kCount + 16, 1.0f);
+    for (size_t offset : {0, 1, 4}) {
+        if (BestSimdLevel() < SimdLevel::kAvx2)
+            break;
+
+        long long ms = MeasureMs([&] {
+            for (int i = 0; i < kRounds; ++i)
+                simd_sink = simd_avx2::Sum(v.Data() + offset, kCount);
+        });
+        std::cerr << "  " << offset * sizeof(float) << " bytes past a cache line: "
+                  << kGigabytes / (static_cast<double>(std::max(ms, 1LL)) / 1000) << " GB/s" << std::endl;
+    }
+
+    const size_t kBigCount = 32'000'000;
+    const size_t kLookups = 20'000'000;
+    std::cerr << "Random reads (" << kLookups << " over " << kBigCount * 8 / (1 << 20) << " MB):" << std::endl;
+    auto random_reads = [&](const auto& big) {
+        return MeasureMs([&] {
+            uint64_t state = 1;
+            uint64_t sum = 0;
+            for (size_t i = 0; i < kLookups; ++i) {
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                sum += big[(state >> 20) % kBigCount];
+            }
+            simd_sink = static_cast<double>(sum);
+        });
+    };
+    Vector<uint64_t, AlignedAllocator<uint64_t, 64>> small_pages(kBigCount, 1);
+    std::cerr << "  4 KB pages: " << random_reads(small_pages) << " ms" << std::endl;
+    Vector<uint64_t, AlignedAllocator<uint64_t, 64, true>> huge_pages(kBigCount, 1);
+    std::cerr << "  huge pages: " << random_reads(huge_pages) << " ms" << std::endl;
+}
+
+// Runs body(thread) on threads threads at once
+template <typename Body>
+long long ThreadsMs(size_t threads, Body&& body) {
+    return MeasureMs([&] {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; ++t)
+            workers.emplace_back([&body, t] { body(t); });
+        for (auto& worker : workers)
+            worker.join();
+    });
+}
+
+// A 64-byte order record, of which the scans below need one or two fields
+struct Symbol {
+    char text[40] = {};
+};
+
+struct Order {
+    int64_t id = 0;
+    double price = 0;
+    int32_t quantity = 0;
+    int32_t flags = 0;
+    Symbol symbol;
+};
+
+void BenchmarkSoa() {
+    const size_t kCount = 8'000'000;
+    const int kRounds = 10;
+
+    std::cerr << "Column scans (" << kCount << " rows of " << sizeof(Order) << " bytes, " << kRounds << " rounds):" << std::endl;
+    Vector<Order> rows;
+    SoAVector<Tuple<int64_t, double, int32_t, int32_t, Symbol>> columns;
+    rows.Reserve(kCount);
+    columns.Reserve(kCount);
+    for (size_t i = 0; i < kCount; ++i) {
+        Order order;
+        order.id = static_cast<int64_t>(i);
+        order.price = static_cast<double>(i % 1000) / 8;
+        order.quantity = static_cast<int32_t>(i % 7);
+        rows.PushBack(order);
+        columns.EmplaceBack(order.id, order.price, order.quantity, order.flags, order.symbol);
+    }
+
+    long long aos_one = MeasureMs([&] {
+        for (int round = 0; round < kRounds; ++round) {
+            double sum = 0;
+            for (const Order& order : rows)
+                sum += order.price;
+            simd_sink = sum;
+        }
+    });
+    long long soa_one = MeasureMs([&] {
+        for (int round = 0; round < kRounds; ++round) {
+            double sum = 0;
+            for (double price : columns.Column<1>())
+                sum += price;
+            simd_sink = sum;
+        }
+    });
+    std::cerr << "  sum of price:            AoS " << aos_one << " ms, SoA " << soa_one << " ms" << std::endl;
+
+    long long aos_two = MeasureMs([&] {
+        for (int round = 0; round < kRounds; ++round) {
+            double sum = 0;
+            for (const Order& order : rows)
+                sum += order.price * order.quantity;
+            simd_sink = sum;
+        }
+    });
+    long long soa_two = MeasureMs([&] {
+        for (int round = 0; round < kRounds; ++round) {
+            auto prices = columns.Column<1>();
+            auto quantities = columns.Column<2>();
+            double sum = 0;
+            for (size_t i = 0; i < prices.size(); ++i)
+                sum += prices[i] * quantities[i];
+            simd_sink = sum;
+        }
+    });
+    std::cerr << "  sum of price * quantity: AoS " << aos_two << " ms, SoA " << soa_two << " ms" << std::endl;
+}
+
+void BenchmarkPersistent() {
+    const size_t kCount = 4'000'000;
+    const int kSnapshots = 100;
+
+    std::cerr << "Snapshots of " << kCount << " ints (" << kSnapshots << " snapshots, each followed by one Set):" << std::endl;
+    Vector<int> v;
+    auto transient = PersistentVector<int>().AsTransient();
+    long long build_vector = MeasureMs([&] {
+        Vector<int> built;
+        for (size_t i = 0; i < kCount; ++i)
+            built.PushBack(static_cast<int>(i));
+        v = built;
+    }, 1);
+    long long build_transient = MeasureMs([&] {
+        for (size_t i = 0; i < kCount; ++i)
+            transient.PushBack(static_cast<int>(i));
+    }, 1);
+    PersistentVector<int> pv = transient.Persistent();
+    long long build_persistent = MeasureMs([&] {
+        PersistentVector<int> built;
+        for (size_t i = 0; i < kCount; ++i)
+            built = built.PushBack(static_cast<int>(i));
+    }, 1);
+    std::cerr << "  build: Vector " << build_vector << " ms, Transient " << build_transient
+              << " ms, PushBack of versions " << build_persistent << " ms" << std::endl;
+
+    long long copy_snapshots = MeasureMs([&] {
+        for (int i = 0; i < kSnapshots; ++i) {
+            Vector<int> snapshot = v;
+            v[static_cast<size_t>(i)] = -i;
+            simd_sink = snapshot[static_cast<size_t>(i)];
+        }
+    }, 1);
+    long long persistent_snapshots = MeasureMs([&] {
+        for (int i = 0; i < kSnapshots; ++i) {
+            PersistentVector<int> snapshot = pv;
+            pv = pv.Set(static_cast<size_t>(i), -i);
+            simd_sink = snapshot[static_cast<size_t>(i)];
+        }
+    }, 1);
+    std::cerr << "  snapshots: Vector copy " << copy_snapshots << " ms, PersistentVector " << persistent_snapshots
+              << " ms" << std::endl;
+
+    long long scan_vector = MeasureMs([&] {
+        int64_t sum = 0;
+        for (int x : v)
+            sum += x;
+        simd_sink = static_cast<double>(sum);
+    });
+    long long scan_persistent = MeasureMs([&] {
+        int64_t sum = 0;
+        for (int x : pv)
+            sum += x;
+        simd_sink = static_cast<double>(sum);
+    });
+    std::cerr << "  scan: Vector " << scan_vector << " ms, PersistentVector " << scan_persistent << " ms" << std::endl;
+}
+
+void BenchmarkBitVector() {
+    const size_t kCount = 64'000'000;
+
+    std::cerr << "Flags (" << kCount << " flags, every 3rd set and every 5th in the mask):" << std::endl;
+    Vector<bool> bytes(kCount, false);
+    Vector<bool> byte_mask(kCount, false);
+    BitVector bits(kCount);
+    BitVector mask(kCount);
+    for (size_t i = 0; i < kCount; i += 3) {
+        bytes[i] = true;
+        bits.Set(i);
+    }
+    for (size_t i = 0; i < kCount; i += 5) {
+        byte_mask[i] = true;
+        mask.Set(i);
+    }
+
+    long long count_bytes = MeasureMs([&] {
+        simd_sink = static_cast<double>(std::count(bytes.begin(), bytes.end(), true));
+    });
+    long long count_bits = MeasureMs([&] {
+        simd_sink = static_cast<double>(bits.Count());
+    });
+    std::cerr << "  count:         Vector<bool> " << count_bytes << " ms, BitVector " << count_bits << " ms" << std::endl;
+
+    long long and_bytes = MeasureMs([&] {
+        for (size_t i = 0; i < kCount; ++i)
+            bytes[i] = bytes[i] && byte_mask[i];
+    });
+    long long and_bits = MeasureMs([&] {
+        bits &= mask;
+    });
+    std::cerr << "  and:           Vector<bool> " << and_bytes << " ms, BitVector " << and_bits << " ms" << std::endl;
+
+    long long scan_bytes = MeasureMs([&] {
+        size_t sum = 0;
+        for (size_t i = 0; i < kCount; ++i) {
+            if (bytes[i])
+                sum += i;
+        }
+        simd_sink = static_cast<double>(sum);
+    });
+    long long scan_bits = MeasureMs([&] {
+        size_t sum = 0;
+        bits.ForEachSet([&sum](size_t i) { sum += i; });
+        simd_sink = static_cast<double>(sum);
+    });
+    std::cerr << "  visit the set: Vector<bool> " << scan_bytes << " ms, BitVector " << scan_bits << " ms" << std::endl;
+}
+
+template <typename Compressed>
+void CompressedTest(const char* name, const Vector<uint64_t>& values, double plain_ms) {
+    Compressed compressed(values.begin(), values.end());
+    double bytes_per_value = static_cast<double>(compressed.MemoryBytes()) / static_cast<double>(values.Size());
+
+    long long decode = MeasureMs([&] {
+        uint64_t sum = 0;
+        compressed.ForEachBlock([&sum](const uint64_t* block, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                sum += block[i];
+        });
+        simd_sink = static_cast<double>(sum);
+    });
+    long long random = MeasureMs([&] {
+        uint64_t sum = 0;
+        for (size_t i = 0, idx = 0; i < 1'000'000; ++i, idx = (idx + 7'919'993) % values.Size())
+            sum += compressed[idx];
+        simd_sink = static_cast<double>(sum);
+    });
+    std::cerr << "  " << name << bytes_per_value << " bytes per value, scan " << decode << " ms ("
+              << static_cast<double>(decode) / std::max(plain_ms, 1.0) << "x plain), 1M random reads " << random
+              << " ms" << std::endl;
+}
+
+void BenchmarkCompressed() {
+    const size_t kCount = 32'000'000;
+
+    // Mostly increasing ids of about 25 bits, with a few steps back
+    Vector<uint64_t> values;
+    values.Reserve(kCount);
+    uint64_t current = 1 << 20;
+    for (size_t i = 0; i < kCount; ++i) {
+        current += (i * 2'654'435'761u >> 7) % 16;
+        values.PushBack(i % 50 == 0 ? current - i % 1000 : current);
+    }
+
+    std::cerr << "Compressed ids (" << kCount << " values up to " << BitWidth(values.Back()) << " bits):" << std::endl;
+    long long plain = MeasureMs([&] {
+        uint64_t sum = 0;
+        for (uint64_t value : values)
+            sum += value;
+        simd_sink = static_cast<double>(sum);
+    });
+    std::cerr << "  Vector:            8 bytes per value, scan " << plain << " ms" << std::endl;
+    CompressedTest<PackedVector>("PackedVector:      ", values, static_cast<double>(plain));
+    CompressedTest<FrameOfReferenceVector>("FrameOfReference:  ", values, static_cast<double>(plain));
+    CompressedTest<DeltaVector>("DeltaVector:       ", values, static_cast<double>(plain));
+
+    Vector<uint64_t> unpacked(kPackedBlockSize);
+    PackedVector packed(values.begin(), values.end());
+    const char* level_names[] = {"scalar", "SSE2", "AVX2"};
+    std::cerr << "  UnpackBlock:";
+    for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2}) {
+        if (level > BestSimdLevel())
+            break;
+        long long ms = MeasureMs([&] {
+            for (size_t block = 0; block + 1 < packed.BlockCount(); ++block)
+                packed.DecodeBlock(block, unpacked.Data(), level);
+            simd_sink = static_cast<double>(unpacked[0]);
+        });
+        std::cerr << " " << level_names[static_cast<int>(level)] << " " << ms << " ms";
+    }
+    std::cerr << std::endl;
+}
+
+void BenchmarkJagged() {
+    const size_t kRows = 4'000'000;
+
+    // Adjacency lists of a graph with 0 to 15 edges per vertex
+    std::vector<size_t> counts(kRows);
+    for (size_t row = 0; row < kRows; ++row)
+        counts[row] = (row * 2'654'435'761u >> 11) % 16;
+
+    std::cerr << "Adjacency lists (" << kRows << " rows of 0 to 15):" << std::endl;
+    auto build_nested = [&counts] {
+        std::vector<std::vector<size_t>> nested(counts.size());
+        for (size_t row = 0; row < counts.size(); ++row) {
+            for (size_t i = 0; i < counts[row]; ++i)
+                nested[row].push_back(row + i);
+        }
+        return nested;
+    };
+    auto build_jagged = [&counts] {
+        auto jagged = JaggedVector<size_t>::FromCounts(counts);
+        for (size_t row = 0; row < counts.size(); ++row) {
+            for (size_t i = 0; i < counts[row]; ++i)
+                jagged.PushBackToRow(row, row + i);
+        }
+        return jagged;
+    };
+
+    long nested_rss = PeakRssMb([&] { simd_sink = static_cast<double>(build_nested().size()); });
+    long jagged_rss = PeakRssMb([&] { simd_sink = static_cast<double>(build_jagged().Size()); });
+
+    std::vector<std::vector<size_t>> nested;
+    long long nested_build = MeasureMs([&] { nested = build_nested(); }, 1);
+    JaggedVector<size_t> jagged;
+    long long jagged_build = MeasureMs([&] { jagged = build_jagged(); }, 1);
+
+    long long nested_scan = MeasureMs([&] {
+        size_t sum = 0;
+        for (const auto& row : nested) {
+            for (size_t to : row)
+                sum += to;
+        }
+        simd_sink = static_cast<double>(sum);
+    });
+    long long jagged_scan = MeasureMs([&] {
+        size_t sum = 0;
+        for (size_t row = 0; row < jagged.Size(); ++row) {
+            for (size_t to : jagged[row])
+                sum += to;
+        }
+        simd_sink = static_cast<double>(sum);
+    });
+
+    std::cerr << "  vector of vectors: peak RSS " << nested_rss << " MB, build " << nested_build << " ms, scan "
+              << nested_scan << " ms" << std::endl;
+    std::cerr << "  JaggedVector:      peak RSS " << jagged_rss << " MB, build " << jagged_build << " ms, scan "
+              << jagged_scan << " ms" << std::endl;
+}
+
+void BenchmarkConcurrentAppend() {
+    const size_t kCount = 16'000'000;
+
+    std::cerr << "Concurrent append (" << kCount << " uint64_t from all threads together):" << std::endl;
+    for (size_t threads : {1, 2, 4, 8}) {
+        size_t per_thread = kCount / threads;
+        long long locked = ThreadsMs(threads, [per_thread](size_t) {});
+        {
+            Vector<uint64_t> v;
+            std::mutex mutex;
+            locked = ThreadsMs(threads, [&](size_t t) {
+                for (size_t i = 0; i < per_thread; ++i) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    v.PushBack(t * per_thread + i);
+                }
+            });
+        }
+
+        long long concurrent = ThreadsMs(threads, [per_thread](size_t) {});
+        long long reserved = concurrent;
+        {
+            auto v = std::make_unique<ConcurrentVector<uint64_t>>();
+            concurrent = ThreadsMs(threads, [&](size_t t) {
+                for (size_t i = 0; i < per_thread; ++i)
+                    v->PushBack(t * per_thread + i);
+            });
+        }
+        {
+            auto v = std::make_unique<ConcurrentVector<uint64_t>>();
+            v->Reserve(kCount * 3);
+            reserved = ThreadsMs(threads, [&](size_t t) {
+                for (size_t i = 0; i < per_thread; ++i)
+                    v->PushBack(t * per_thread + i);
+            });
+        }
+
+        std::cerr << "  " << threads << " threads: Vector with mutex " << locked << " ms, ConcurrentVector "
+                  << concurrent << " ms, reserved " << reserved << " ms" << std::endl;
+    }
+}
+
+int main() {
+    BenchmarkRelocation();
+    BenchmarkHugeGrowth();
+    BenchmarkGrowthPolicies();
+    BenchmarkSimd();
+    BenchmarkMapped();
+    BenchmarkAlignment();
+    BenchmarkSoa();
+    BenchmarkPersistent();
+    BenchmarkBitVector();
+    BenchmarkCompressed();
+    BenchmarkJagged();
+    // Last: the thread pool it starts would not survive the forks above
+    BenchmarkParallel();
+    BenchmarkConcurrentAppend();
+}
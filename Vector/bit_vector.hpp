@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "vector.hpp"
+#include "bit_vector_kernels.hpp"
+
+// Vector of bits packed 64 to a word. Besides the per-bit interface it works on whole
+// words: Count and Rank use popcount, FindFirst/FindNext skip empty words, and the
+// bitwise operators combine two vectors with SIMD kernels. The bits of the last word
+// past Size() are always zero, which is what lets the word loops ignore the tail.
+class BitVector {
+
+public:
+
+using WordType = uint64_t;
+using SizeType = size_t;
+
+static constexpr size_t kWordBits = 64;
+// Returned by FindFirst and FindNext when there is no set bit
+static constexpr size_t kNpos = static_cast<size_t>(-1);
+
+
+// What operator[] returns for a mutable vector, like std::vector<bool>::reference
+class Reference {
+public:
+    Reference(WordType* word, WordType mask) : word_(word), mask_(mask) {}
+
+    Reference& operator=(bool value) {
+        if (value) {
+            *word_ |= mask_;
+        } else {
+            *word_ &= ~mask_;
+        }
+        return *this;
+    }
+
+    Reference& operator=(const Reference& other) {
+        return *this = static_cast<bool>(other);
+    }
+
+    operator bool() const {
+        return (*word_ & mask_) != 0;
+    }
+
+    void Flip() {
+        *word_ ^= mask_;
+    }
+
+private:
+    WordType* word_;
+    WordType mask_;
+};
+
+
+//------------------------------constructors------------------------------
+
+    BitVector() = default;
+
+    explicit BitVector(size_t size, bool value = false) {
+        Resize(size, value);
+    }
+
+//-----------------------------operators--------------------------------
+
+    bool operator[](size_t idx) const {
+        return Test(idx);
+    }
+
+    Reference operator[](size_t idx) {
+        return Reference(&words_[idx / kWordBits], Bit(idx));
+    }
+
+    bool operator==(const BitVector& other) const {
+        if (size_ != other.size_)
+            return false;
+        for (size_t i = 0; i < words_.Size(); ++i) {
+            if (words_[i] != other.words_[i])
+                return false;
+        }
+        return true;
+    }
+
+    bool operator!=(const BitVector& other) const {
+        return !(*this == other);
+    }
+
+    // The bitwise operators need vectors of the same size
+    BitVector& operator&=(const BitVector& other) {
+        return Combine<BitOp::kAnd>(other);
+    }
+
+    BitVector& operator|=(const BitVector& other) {
+        return Combine<BitOp::kOr>(other);
+    }
+
+    BitVector& operator^=(const BitVector& other) {
+        return Combine<BitOp::kXor>(other);
+    }
+
+    BitVector operator&(const BitVector& other) const {
+        BitVector result(*this);
+        return result &= other;
+    }
+
+    BitVector operator|(const BitVector& other) const {
+        BitVector result(*this);
+        return result |= other;
+    }
+
+    BitVector operator^(const BitVector& other) const {
+        BitVector result(*this);
+        return result ^= other;
+    }
+
+//-----------------------------methods----------------------------------
+
+    bool Test(size_t idx) const {
+        return (words_[idx / kWordBits] & Bit(idx)) != 0;
+    }
+
+    bool At(size_t idx) const {
+        if (idx >= size_)
+            throw std::out_of_range("Out of range");
+        return Test(idx);
+    }
+
+    void Set(size_t idx, bool value = true) {
+        (*this)[idx] = value;
+    }
+
+    void Reset(size_t idx) {
+        words_[idx / kWordBits] &= ~Bit(idx);
+    }
+
+    void Flip(size_t idx) {
+        words_[idx / kWordBits] ^= Bit(idx);
+    }
+
+    // Clears the bits that are set in other
+    BitVector& AndNot(const BitVector& other) {
+        return Combine<BitOp::kAndNot>(other);
+    }
+
+    void SetAll() {
+        words_.Fill(~WordType(0));
+        ClearTail();
+    }
+
+    void ResetAll() {
+        words_.Fill(0);
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    size_t Capacity() const {
+        return words_.Capacity() * kWordBits;
+    }
+
+    // Number of set bits
+    size_t Count() const {
+        return PopCountWords(words_.Data(), words_.Size());
+    }
+
+    // Number of set bits before idx, idx <= Size()
+    size_t Rank(size_t idx) const {
+        size_t full_words = idx / kWordBits;
+        size_t rank = PopCountWords(words_.Data(), full_words);
+        if (idx % kWordBits != 0)
+            rank += PopCount64(words_[full_words] & (Bit(idx) - 1));
+        return rank;
+    }
+
+    bool Any() const {
+        return FindFirst() != kNpos;
+    }
+
+    bool None() const {
+        return !Any();
+    }
+
+    bool All() const {
+        return Count() == size_;
+    }
+
+    size_t FindFirst() const {
+        return FindFrom(0);
+    }
+
+    // The first set bit after idx
+    size_t FindNext(size_t idx) const {
+        return idx + 1 >= size_ ? kNpos : FindFrom(idx + 1);
+    }
+
+    // Calls func(idx) for every set bit in increasing order
+    template <typename Func>
+    void ForEachSet(Func&& func) const {
+        for (size_t word = 0; word < words_.Size(); ++word) {
+            for (WordType bits = words_[word]; bits != 0; bits &= bits - 1)
+                func(word * kWordBits + static_cast<size_t>(__builtin_ctzll(bits)));
+        }
+    }
+
+    void Reserve(size_t capacity) {
+        words_.Reserve(WordsFor(capacity));
+    }
+
+    void Resize(size_t size, bool value = false) {
+        if (size > size_ && value) {
+            // The rest of the last word, then whole words
+            if (size_ % kWordBits != 0)
+                words_.Back() |= ~(Bit(size_) - 1);
+            words_.Resize(WordsFor(size), ~WordType(0));
+        } else {
+            words_.Resize(WordsFor(size), 0);
+        }
+        size_ = size;
+        ClearTail();
+    }
+
+    void PushBack(bool value) {
+        if (size_ % kWordBits == 0)
+            words_.PushBack(0);
+        ++size_;
+        if (value)
+            Set(size_ - 1);
+    }
+
+    void PopBack() {
+        if (size_ == 0)
+            return;
+
+        Reset(size_ - 1);
+        --size_;
+        if (size_ % kWordBits == 0)
+            words_.PopBack();
+    }
+
+    void Clear() {
+        words_.Clear();
+        size_ = 0;
+    }
+
+    void ShrinkToFit() {
+        words_.ShrinkToFit();
+    }
+
+    void Swap(BitVector& other) noexcept {
+        words_.Swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    // The words themselves, bit i is bit i % 64 of word i / 64
+    const WordType* Words() const {
+        return words_.Data();
+    }
+
+    WordType* Words() {
+        return words_.Data();
+    }
+
+    size_t WordCount() const {
+        return words_.Size();
+    }
+
+private:
+    static WordType Bit(size_t idx) {
+        return WordType(1) << (idx % kWordBits);
+    }
+
+    static size_t WordsFor(size_t bits) {
+        return (bits + kWordBits - 1) / kWordBits;
+    }
+
+    void ClearTail() {
+        if (size_ % kWordBits != 0)
+            words_.Back() &= Bit(size_) - 1;
+    }
+
+    size_t FindFrom(size_t idx) const {
+        if (idx >= size_)
+            return kNpos;
+
+        size_t word = idx / kWordBits;
+        WordType bits = words_[word] & ~(Bit(idx) - 1);
+        while (bits == 0) {
+            if (++word == words_.Size())
+                return kNpos;
+            bits = words_[word];
+        }
+        return word * kWordBits + static_cast<size_t>(__builtin_ctzll(bits));
+    }
+
+    template <BitOp kOp>
+    BitVector& Combine(const BitVector& other) {
+        if (size_ != other.size_)
+            throw std::invalid_argument("BitVector sizes differ");
+        CombineWords<kOp>(words_.Data(), other.words_.Data(), words_.Size());
+        return *this;
+    }
+
+    Vector<WordType> words_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "simd_algorithms.hpp"
+
+// Word kernels of BitVector: bitwise combination and popcount over arrays of uint64_t
+// bit sets. Like the algorithms of simd_algorithms.hpp, every instruction set namespace
+// gets its own WordOps and a copy of bit_vector_kernels_isa.hpp, and the functions at
+// the end pick one with the same dispatch.
+
+// Number of set bits in a word, without the library call __builtin_popcountll
+// becomes when -mpopcnt isn't given
+inline size_t PopCount64(uint64_t word) {
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<size_t>((word * 0x0101010101010101ULL) >> 56);
+}
+
+// Bitwise operations of the word kernels, kAndNot clears the bits set in the second operand
+enum class BitOp {
+    kAnd,
+    kOr,
+    kXor,
+    kAndNot,
+};
+
+namespace simd_scalar {
+
+// Word operations: Counts gives the number of set bits per 64-bit lane
+struct WordOps {
+    static constexpr size_t kWords = 1;
+
+    static uint64_t Load(const uint64_t* ptr) { return *ptr; }
+    static void Store(uint64_t* ptr, uint64_t reg) { *ptr = reg; }
+    static uint64_t Zero() { return 0; }
+    static uint64_t Counts(uint64_t reg) { return PopCount64(reg); }
+    static uint64_t AddCounts(uint64_t a, uint64_t b) { return a + b; }
+    static size_t SumCounts(uint64_t reg) { return static_cast<size_t>(reg); }
+
+    template <BitOp kOp>
+    static uint64_t Apply(uint64_t a, uint64_t b) {
+        if constexpr (kOp == BitOp::kAnd) {
+            return a & b;
+        } else if constexpr (kOp == BitOp::kOr) {
+            return a | b;
+        } else if constexpr (kOp == BitOp::kXor) {
+            return a ^ b;
+        } else {
+            return a & ~b;
+        }
+    }
+};
+
+#include "bit_vector_kernels_isa.hpp"
+
+}  // namespace simd_scalar
+
+#ifdef VECTOR_SIMD_X86
+
+namespace simd_sse2 {
+
+struct WordOps {
+    static constexpr size_t kWords = 2;
+
+    static __m128i Load(const uint64_t* ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+    static void Store(uint64_t* ptr, __m128i reg) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), reg); }
+    static __m128i Zero() { return _mm_setzero_si128(); }
+
+    // Bits per byte the SWAR way, then psadbw sums the bytes of each lane
+    static __m128i Counts(__m128i reg) {
+        const __m128i m1 = _mm_set1_epi8(0x55);
+        const __m128i m2 = _mm_set1_epi8(0x33);
+        const __m128i m4 = _mm_set1_epi8(0x0F);
+        reg = _mm_sub_epi8(reg, _mm_and_si128(_mm_srli_epi64(reg, 1), m1));
+        reg = _mm_add_epi8(_mm_and_si128(reg, m2), _mm_and_si128(_mm_srli_epi64(reg, 2), m2));
+        reg = _mm_and_si128(_mm_add_epi8(reg, _mm_srli_epi64(reg, 4)), m4);
+        return _mm_sad_epu8(reg, _mm_setzero_si128());
+    }
+
+    static __m128i AddCounts(__m128i a, __m128i b) { return _mm_add_epi64(a, b); }
+
+    static size_t SumCounts(__m128i reg) {
+        uint64_t lanes[kWords];
+        Store(lanes, reg);
+        size_t sum = 0;
+        for (size_t lane = 0; lane < kWords; ++lane)
+            sum += static_cast<size_t>(lanes[lane]);
+        return sum;
+    }
+
+    template <BitOp kOp>
+    static __m128i Apply(__m128i a, __m128i b) {
+        if constexpr (kOp == BitOp::kAnd) {
+            return _mm_and_si128(a, b);
+        } else if constexpr (kOp == BitOp::kOr) {
+            return _mm_or_si128(a, b);
+        } else if constexpr (kOp == BitOp::kXor) {
+            return _mm_xor_si128(a, b);
+        } else {
+            return _mm_andnot_si128(b, a);
+        }
+    }
+};
+
+#include "bit_vector_kernels_isa.hpp"
+
+}  // namespace simd_sse2
+
+#ifdef __clang__
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace simd_avx2 {
+
+struct WordOps {
+    static constexpr size_t kWords = 4;
+
+    static __m256i Load(const uint64_t* ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+    static void Store(uint64_t* ptr, __m256i reg) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), reg); }
+    static __m256i Zero() { return _mm256_setzero_si256(); }
+
+    // Bits per byte the SWAR way, then psadbw sums the bytes of each lane
+    static __m256i Counts(__m256i reg) {
+        const __m256i m1 = _mm256_set1_epi8(0x55);
+        const __m256i m2 = _mm256_set1_epi8(0x33);
+        const __m256i m4 = _mm256_set1_epi8(0x0F);
+        reg = _mm256_sub_epi8(reg, _mm256_and_si256(_mm256_srli_epi64(reg, 1), m1));
+        reg = _mm256_add_epi8(_mm256_and_si256(reg, m2), _mm256_and_si256(_mm256_srli_epi64(reg, 2), m2));
+        reg = _mm256_and_si256(_mm256_add_epi8(reg, _mm256_srli_epi64(reg, 4)), m4);
+        return _mm256_sad_epu8(reg, _mm256_setzero_si256());
+    }
+
+    static __m256i AddCounts(__m256i a, __m256i b) { return _mm256_add_epi64(a, b); }
+
+    static size_t SumCounts(__m256i reg) {
+        uint64_t lanes[kWords];
+        Store(lanes, reg);
+        size_t sum = 0;
+        for (size_t lane = 0; lane < kWords; ++lane)
+            sum += static_cast<size_t>(lanes[lane]);
+        return sum;
+    }
+
+    template <BitOp kOp>
+    static __m256i Apply(__m256i a, __m256i b) {
+        if constexpr (kOp == BitOp::kAnd) {
+            return _mm256_and_si256(a, b);
+        } else if constexpr (kOp == BitOp::kOr) {
+            return _mm256_or_si256(a, b);
+        } else if constexpr (kOp == BitOp::kXor) {
+            return _mm256_xor_si256(a, b);
+        } else {
+            return _mm256_andnot_si256(b, a);
+        }
+    }
+};
+
+#include "bit_vector_kernels_isa.hpp"
+
+}  // namespace simd_avx2
+
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif
+
+// dst[i] = dst[i] op src[i] for size words
+template <BitOp kOp>
+void CombineWords(uint64_t* dst, const uint64_t* src, size_t size, SimdLevel level = BestSimdLevel()) {
+    VECTOR_SIMD_DISPATCH(level, CombineWords<kOp>, dst, src, size)
+}
+
+// Number of set bits in size words
+inline size_t PopCountWords(const uint64_t* words, size_t size, SimdLevel level = BestSimdLevel()) {
+    VECTOR_SIMD_DISPATCH(level, PopCountWords, words, size)
+}
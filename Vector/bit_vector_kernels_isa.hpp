@@ -0,0 +1,29 @@
+// Word kernels written once against WordOps of the namespace that includes this file.
+// bit_vector_kernels.hpp includes it once per instruction set, so there is no include
+// guard on purpose.
+
+template <BitOp kOp>
+void CombineWords(uint64_t* dst, const uint64_t* src, size_t size) {
+    using O = WordOps;
+    size_t i = 0;
+    for (; i + O::kWords <= size; i += O::kWords)
+        O::Store(dst + i, O::template Apply<kOp>(O::Load(dst + i), O::Load(src + i)));
+    for (; i < size; ++i)
+        dst[i] = simd_scalar::WordOps::Apply<kOp>(dst[i], src[i]);
+}
+
+// Two accumulators, psadbw has a latency of a few cycles
+inline size_t PopCountWords(const uint64_t* words, size_t size) {
+    using O = WordOps;
+    auto acc0 = O::Zero();
+    auto acc1 = acc0;
+    size_t i = 0;
+    for (; i + 2 * O::kWords <= size; i += 2 * O::kWords) {
+        acc0 = O::AddCounts(acc0, O::Counts(O::Load(words + i)));
+        acc1 = O::AddCounts(acc1, O::Counts(O::Load(words + i + O::kWords)));
+    }
+    size_t count = O::SumCounts(O::AddCounts(acc0, acc1));
+    for (; i < size; ++i)
+        count += PopCount64(words[i]);
+    return count;
+}
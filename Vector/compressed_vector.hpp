@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "vector.hpp"
+#include "compressed_vector_kernels.hpp"
+
+// Append-only vectors of uint64_t that keep their values compressed in blocks of
+// kPackedBlockSize. The codec decides the encoding of a block:
+//   BitPackCodec           - every value in width bits, the width of the block's largest value
+//   FrameOfReferenceCodec  - the same for the differences to the block's smallest value
+//   DeltaVarintCodec       - differences to the previous value as varints, for sorted data
+// Values are appended to an open block kept as plain numbers, which gets encoded when full.
+// operator[] decodes one value, DecodeBlock and ForEachBlock a whole block at a time.
+
+inline unsigned BitWidth(uint64_t value) {
+    return value == 0 ? 0 : 64 - static_cast<unsigned>(__builtin_clzll(value));
+}
+
+// Packs values minus base into the layout UnpackBlock reads, width * kPackedLanes words
+inline void PackBlock(const uint64_t* values, unsigned width, uint64_t base, uint64_t* packed) {
+    std::fill(packed, packed + width * kPackedLanes, 0);
+    if (width == 0)
+        return;
+
+    for (size_t lane = 0; lane < kPackedLanes; ++lane) {
+        uint64_t* row = packed + lane;
+        unsigned bit = 0;
+        for (size_t i = lane; i < kPackedBlockSize; i += kPackedLanes) {
+            uint64_t value = values[i] - base;
+            *row |= value << bit;
+            if (bit + width > 64)
+                row[kPackedLanes] |= value >> (64 - bit);
+            bit += width;
+            if (bit >= 64) {
+                bit -= 64;
+                row += kPackedLanes;
+            }
+        }
+    }
+}
+
+// Value idx of a packed block without unpacking the rest
+inline uint64_t UnpackOne(const uint64_t* packed, unsigned width, uint64_t base, size_t idx) {
+    if (width == 0)
+        return base;
+
+    size_t bit_offset = idx / kPackedLanes * width;
+    const uint64_t* row = packed + bit_offset / 64 * kPackedLanes + idx % kPackedLanes;
+    unsigned bit = static_cast<unsigned>(bit_offset % 64);
+    uint64_t value = *row >> bit;
+    if (bit + width > 64)
+        value |= row[kPackedLanes] << (64 - bit);
+    if (width < 64)
+        value &= (uint64_t(1) << width) - 1;
+    return value + base;
+}
+
+// Appends count zeroed words to data for a block, growing it geometrically:
+// Resize alone allocates exactly the new size, which would copy data for every block
+inline uint64_t* AppendPackedWords(Vector<uint64_t>& data, size_t count) {
+    size_t size = data.Size();
+    if (data.Capacity() < size + count)
+        data.Reserve(std::max(size + count, 2 * data.Capacity()));
+    data.Resize(size + count);
+    return data.Data() + size;
+}
+
+struct BitPackCodec {
+    using Word = uint64_t;
+
+    struct Block {
+        size_t offset;
+        unsigned width;
+    };
+
+    static Block Encode(const uint64_t* values, Vector<Word>& data) {
+        uint64_t all = 0;
+        for (size_t i = 0; i < kPackedBlockSize; ++i)
+            all |= values[i];
+
+        Block block{data.Size(), BitWidth(all)};
+        PackBlock(values, block.width, 0, AppendPackedWords(data, block.width * kPackedLanes));
+        return block;
+    }
+
+    static void Decode(const Block& block, const Word* data, uint64_t* out, SimdLevel level) {
+        UnpackBlock(data + block.offset, block.width, 0, out, level);
+    }
+
+    static uint64_t Get(const Block& block, const Word* data, size_t idx) {
+        return UnpackOne(data + block.offset, block.width, 0, idx);
+    }
+};
+
+struct FrameOfReferenceCodec {
+    using Word = uint64_t;
+
+    struct Block {
+        uint64_t base;
+        size_t offset;
+        unsigned width;
+    };
+
+    static Block Encode(const uint64_t* values, Vector<Word>& data) {
+        uint64_t min = values[0];
+        uint64_t max = values[0];
+        for (size_t i = 1; i < kPackedBlockSize; ++i) {
+            min = std::min(min, values[i]);
+            max = std::max(max, values[i]);
+        }
+
+        Block block{min, data.Size(), BitWidth(max - min)};
+        PackBlock(values, block.width, block.base, AppendPackedWords(data, block.width * kPackedLanes));
+        return block;
+    }
+
+    static void Decode(const Block& block, const Word* data, uint64_t* out, SimdLevel level) {
+        UnpackBlock(data + block.offset, block.width, block.base, out, level);
+    }
+
+    static uint64_t Get(const Block& block, const Word* data, size_t idx) {
+        return UnpackOne(data + block.offset, block.width, block.base, idx);
+    }
+};
+
+// Differences are zigzag encoded, so unsorted data works too, just with longer varints.
+// Decoding is sequential: Get reads the block up to idx, and there is no SIMD decode.
+struct DeltaVarintCodec {
+    using Word = uint8_t;
+
+    struct Block {
+        uint64_t first;
+        size_t offset;
+    };
+
+    static Block Encode(const uint64_t* values, Vector<Word>& data) {
+        Block block{values[0], data.Size()};
+        for (size_t i = 1; i < kPackedBlockSize; ++i) {
+            uint64_t delta = values[i] - values[i - 1];
+            // Zigzag: small negative differences become small odd numbers
+            uint64_t zigzag = (delta << 1) ^ (static_cast<uint64_t>(static_cast<int64_t>(delta) >> 63));
+            for (; zigzag >= 0x80; zigzag >>= 7)
+                data.PushBack(static_cast<Word>(zigzag | 0x80));
+            data.PushBack(static_cast<Word>(zigzag));
+        }
+        return block;
+    }
+
+    static void Decode(const Block& block, const Word* data, uint64_t* out, SimdLevel) {
+        DecodePrefix(block, data, out, kPackedBlockSize);
+    }
+
+    static uint64_t Get(const Block& block, const Word* data, size_t idx) {
+        const Word* ptr = data + block.offset;
+        uint64_t value = block.first;
+        for (size_t i = 0; i < idx; ++i)
+            value += NextDelta(ptr);
+        return value;
+    }
+
+private:
+    static uint64_t NextDelta(const Word*& ptr) {
+        uint64_t zigzag = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            Word byte = *ptr++;
+            zigzag |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                break;
+        }
+        return (zigzag >> 1) ^ (0 - (zigzag & 1));
+    }
+
+    static void DecodePrefix(const Block& block, const Word* data, uint64_t* out, size_t count) {
+        const Word* ptr = data + block.offset;
+        out[0] = block.first;
+        for (size_t i = 1; i < count; ++i)
+            out[i] = out[i - 1] + NextDelta(ptr);
+    }
+};
+
+template <typename Codec>
+class CompressedVector {
+
+public:
+
+using ValueType = uint64_t;
+using SizeType = size_t;
+using Block = typename Codec::Block;
+
+static constexpr size_t kBlockSize = kPackedBlockSize;
+
+
+//------------------------------constructors------------------------------
+
+    CompressedVector() = default;
+
+    template <typename InputIt>
+    CompressedVector(InputIt begin, InputIt end) {
+        for (; begin != end; ++begin)
+            PushBack(*begin);
+    }
+
+//-----------------------------operators--------------------------------
+
+    uint64_t operator[](size_t idx) const {
+        size_t block = idx / kBlockSize;
+        if (block == blocks_.Size())
+            return open_[idx % kBlockSize];
+        return Codec::Get(blocks_[block], data_.Data(), idx % kBlockSize);
+    }
+
+//-----------------------------methods----------------------------------
+
+    uint64_t At(size_t idx) const {
+        if (idx >= size_)
+            throw std::out_of_range("Out of range");
+        return (*this)[idx];
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    // Encoded blocks and the open one, if it has values
+    size_t BlockCount() const {
+        return blocks_.Size() + (open_.Empty() ? 0 : 1);
+    }
+
+    // Bytes taken by the values: encoded data, block headers and the open block
+    size_t MemoryBytes() const {
+        return data_.Size() * sizeof(typename Codec::Word) + blocks_.Size() * sizeof(Block) +
+               open_.Size() * sizeof(uint64_t);
+    }
+
+    void PushBack(uint64_t value) {
+        if (open_.Capacity() < kBlockSize)
+            open_.Reserve(kBlockSize);
+
+        open_.PushBack(value);
+        ++size_;
+        if (open_.Size() == kBlockSize)
+            SealOpenBlock();
+    }
+
+    template <typename InputIt>
+    void AppendRange(InputIt begin, InputIt end) {
+        for (; begin != end; ++begin)
+            PushBack(*begin);
+    }
+
+    // Writes the values of block number block to out, room for kBlockSize values,
+    // and returns how many there are
+    size_t DecodeBlock(size_t block, uint64_t* out, SimdLevel level = BestSimdLevel()) const {
+        if (block == blocks_.Size()) {
+            std::copy(open_.begin(), open_.end(), out);
+            return open_.Size();
+        }
+        Codec::Decode(blocks_[block], data_.Data(), out, level);
+        return kBlockSize;
+    }
+
+    // Calls func(values, count) for every block in order, the fast way to read everything
+    template <typename Func>
+    void ForEachBlock(Func&& func, SimdLevel level = BestSimdLevel()) const {
+        uint64_t values[kBlockSize];
+        for (size_t block = 0; block < BlockCount(); ++block) {
+            size_t count = DecodeBlock(block, values, level);
+            func(static_cast<const uint64_t*>(values), count);
+        }
+    }
+
+    Vector<uint64_t> Decompress() const {
+        Vector<uint64_t> values;
+        values.ResizeUninitialized(size_);
+        for (size_t block = 0; block < BlockCount(); ++block)
+            DecodeBlock(block, values.Data() + block * kBlockSize);
+        return values;
+    }
+
+    void Clear() {
+        blocks_.Clear();
+        data_.Clear();
+        open_.Clear();
+        size_ = 0;
+    }
+
+    void ShrinkToFit() {
+        blocks_.ShrinkToFit();
+        data_.ShrinkToFit();
+    }
+
+private:
+    void SealOpenBlock() {
+        size_t data_size = data_.Size();
+        Block block = Codec::Encode(open_.Data(), data_);
+        try {
+            blocks_.PushBack(block);
+        } catch (...) {
+            data_.Resize(data_size);
+            throw;
+        }
+        open_.Clear();
+    }
+
+    Vector<Block> blocks_;
+    Vector<typename Codec::Word> data_;
+    Vector<uint64_t> open_;
+    size_t size_ = 0;
+};
+
+using PackedVector = CompressedVector<BitPackCodec>;
+using FrameOfReferenceVector = CompressedVector<FrameOfReferenceCodec>;
+using DeltaVector = CompressedVector<DeltaVarintCodec>;
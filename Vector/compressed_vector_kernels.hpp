@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "simd_algorithms.hpp"
+
+// UnpackBlock decodes the bit-packed blocks of CompressedVector. Every instruction set
+// namespace of simd_algorithms.hpp gets its own PackOps and a copy of
+// compressed_vector_kernels_isa.hpp, and UnpackBlock picks one with the same dispatch.
+
+namespace simd_scalar {
+
+// Four 64-bit lanes at once, for UnpackBlock
+struct PackOps {
+    struct Reg {
+        uint64_t lanes[4];
+    };
+
+    static Reg Load(const uint64_t* ptr) { return {{ptr[0], ptr[1], ptr[2], ptr[3]}}; }
+    static void Store(uint64_t* ptr, Reg reg) { std::copy(reg.lanes, reg.lanes + 4, ptr); }
+    static Reg Set1(uint64_t value) { return {{value, value, value, value}}; }
+
+    static Reg ShiftRight(Reg reg, unsigned bits) {
+        for (auto& lane : reg.lanes)
+            lane >>= bits;
+        return reg;
+    }
+
+    static Reg ShiftLeft(Reg reg, unsigned bits) {
+        for (auto& lane : reg.lanes)
+            lane <<= bits;
+        return reg;
+    }
+
+    static Reg Or(Reg a, Reg b) {
+        for (size_t i = 0; i < 4; ++i)
+            a.lanes[i] |= b.lanes[i];
+        return a;
+    }
+
+    static Reg And(Reg a, Reg b) {
+        for (size_t i = 0; i < 4; ++i)
+            a.lanes[i] &= b.lanes[i];
+        return a;
+    }
+
+    static Reg Add(Reg a, Reg b) {
+        for (size_t i = 0; i < 4; ++i)
+            a.lanes[i] += b.lanes[i];
+        return a;
+    }
+};
+
+#include "compressed_vector_kernels_isa.hpp"
+
+}  // namespace simd_scalar
+
+#ifdef VECTOR_SIMD_X86
+
+namespace simd_sse2 {
+
+// Four 64-bit lanes in two registers
+struct PackOps {
+    struct Reg {
+        __m128i low;
+        __m128i high;
+    };
+
+    static Reg Load(const uint64_t* ptr) {
+        return {_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 2))};
+    }
+
+    static void Store(uint64_t* ptr, Reg reg) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), reg.low);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr + 2), reg.high);
+    }
+
+    static Reg Set1(uint64_t value) {
+        __m128i reg = _mm_set1_epi64x(static_cast<long long>(value));
+        return {reg, reg};
+    }
+
+    static Reg ShiftRight(Reg reg, unsigned bits) {
+        __m128i count = _mm_cvtsi32_si128(static_cast<int>(bits));
+        return {_mm_srl_epi64(reg.low, count), _mm_srl_epi64(reg.high, count)};
+    }
+
+    static Reg ShiftLeft(Reg reg, unsigned bits) {
+        __m128i count = _mm_cvtsi32_si128(static_cast<int>(bits));
+        return {_mm_sll_epi64(reg.low, count), _mm_sll_epi64(reg.high, count)};
+    }
+
+    static Reg Or(Reg a, Reg b) { return {_mm_or_si128(a.low, b.low), _mm_or_si128(a.high, b.high)}; }
+    static Reg And(Reg a, Reg b) { return {_mm_and_si128(a.low, b.low), _mm_and_si128(a.high, b.high)}; }
+    static Reg Add(Reg a, Reg b) { return {_mm_add_epi64(a.low, b.low), _mm_add_epi64(a.high, b.high)}; }
+};
+
+#include "compressed_vector_kernels_isa.hpp"
+
+}  // namespace simd_sse2
+
+#ifdef __clang__
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace simd_avx2 {
+
+struct PackOps {
+    using Reg = __m256i;
+
+    static Reg Load(const uint64_t* ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+    static void Store(uint64_t* ptr, Reg reg) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), reg); }
+    static Reg Set1(uint64_t value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+    static Reg ShiftRight(Reg reg, unsigned bits) { return _mm256_srl_epi64(reg, _mm_cvtsi32_si128(static_cast<int>(bits))); }
+    static Reg ShiftLeft(Reg reg, unsigned bits) { return _mm256_sll_epi64(reg, _mm_cvtsi32_si128(static_cast<int>(bits))); }
+    static Reg Or(Reg a, Reg b) { return _mm256_or_si256(a, b); }
+    static Reg And(Reg a, Reg b) { return _mm256_and_si256(a, b); }
+    static Reg Add(Reg a, Reg b) { return _mm256_add_epi64(a, b); }
+};
+
+#include "compressed_vector_kernels_isa.hpp"
+
+}  // namespace simd_avx2
+
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif
+
+// Blocks of kPackedBlockSize values of width bits, minus base, are packed into four
+// interleaved lanes: value i is value i / 4 of lane i % 4, and word r of lane k is
+// packed[4 * r + k]. All lanes shift by the same amounts, so they unpack together.
+static constexpr size_t kPackedLanes = 4;
+static constexpr size_t kPackedBlockSize = 256;
+
+// Reads the width * kPackedLanes words of a block and writes its kPackedBlockSize values to out
+inline void UnpackBlock(const uint64_t* packed, unsigned width, uint64_t base, uint64_t* out,
+                        SimdLevel level = BestSimdLevel()) {
+    VECTOR_SIMD_DISPATCH(level, UnpackBlock, packed, width, base, out)
+}
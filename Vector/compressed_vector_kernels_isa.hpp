@@ -0,0 +1,37 @@
+// The unpack kernel written once against PackOps of the namespace that includes this
+// file. compressed_vector_kernels.hpp includes it once per instruction set, so there is
+// no include guard on purpose.
+
+// See the layout next to the public UnpackBlock
+inline void UnpackBlock(const uint64_t* packed, unsigned width, uint64_t base, uint64_t* out) {
+    using O = PackOps;
+    constexpr size_t kLanes = 4;
+    constexpr size_t kPerLane = 64;
+
+    const auto base_reg = O::Set1(base);
+    if (width == 0) {
+        for (size_t j = 0; j < kPerLane; ++j)
+            O::Store(out + j * kLanes, base_reg);
+        return;
+    }
+
+    const auto mask = O::Set1(width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1);
+    auto current = O::Load(packed);
+    const uint64_t* row = packed;
+    unsigned bit = 0;
+    for (size_t j = 0; j < kPerLane; ++j) {
+        auto value = O::ShiftRight(current, bit);
+        unsigned end = bit + width;
+        // A lane holds exactly width words, the last value ends on the last word
+        if (end >= 64 && j + 1 < kPerLane) {
+            row += kLanes;
+            auto next = O::Load(row);
+            if (end > 64)
+                value = O::Or(value, O::ShiftLeft(next, 64 - bit));
+            current = next;
+            end -= 64;
+        }
+        bit = end;
+        O::Store(out + j * kLanes, O::Add(O::And(value, mask), base_reg));
+    }
+}
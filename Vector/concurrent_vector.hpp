@@ -0,0 +1,186 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Vector that many threads may append to at once without a lock. Elements live in
+// segments of 8, 16, 32, ... elements that are never moved or freed while the vector
+// lives, so indices and references handed out by PushBack stay valid.
+//
+// An element may be read by any thread once the PushBack that added it has returned
+// and the reader learned its index through some synchronization, e.g. from the value
+// PushBack returned. Size() counts elements whose construction may still be running.
+// Clear and destruction must not run concurrently with anything else.
+//
+// Elements are built before they get an index and then moved into place, so a
+// throwing constructor leaves no gap; that's why T must be nothrow movable.
+// Running out of memory for a new segment after an index was taken terminates.
+template <typename T>
+class ConcurrentVector {
+
+static_assert(std::is_nothrow_move_constructible_v<T>, "ConcurrentVector moves elements into place after taking an index");
+
+public:
+
+using ValueType = T;
+using Reference = T&;
+using ConstReference = const T&;
+using SizeType = size_t;
+
+
+//------------------------------constructors------------------------------
+
+    ConcurrentVector() = default;
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+
+//-----------------------------destructor--------------------------------
+
+    ~ConcurrentVector() {
+        Clear();
+        for (size_t segment = 0; segment < kSegments; ++segment) {
+            T* data = segments_[segment].load(std::memory_order_relaxed);
+            if (data != nullptr)
+                Deallocate(data, SegmentSize(segment));
+        }
+    }
+
+//-----------------------------operators--------------------------------
+
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    T& operator[](size_t idx) {
+        return Slot(idx);
+    }
+
+    const T& operator[](size_t idx) const {
+        return Slot(idx);
+    }
+
+//-----------------------------methods----------------------------------
+
+    T& At(size_t idx) {
+        if (idx >= Size())
+            throw std::out_of_range("Out of range");
+        return Slot(idx);
+    }
+
+    const T& At(size_t idx) const {
+        if (idx >= Size())
+            throw std::out_of_range("Out of range");
+        return Slot(idx);
+    }
+
+    size_t Size() const {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    // Allocates the segments for the first capacity elements, so that appending
+    // up to there never waits for the allocator
+    void Reserve(size_t capacity) {
+        if (capacity == 0)
+            return;
+
+        for (size_t segment = 0; segment <= SegmentOf(capacity - 1); ++segment)
+            EnsureSegment(segment);
+    }
+
+    // Returns the index of the new element
+    template<typename... Args>
+    size_t EmplaceBack(Args&&... args) {
+        T elem(std::forward<Args>(args)...);
+        size_t idx = size_.fetch_add(1, std::memory_order_acq_rel);
+        new (&SlotForWrite(idx)) T(std::move(elem));
+        return idx;
+    }
+
+    size_t PushBack(const T& elem) {
+        return EmplaceBack(elem);
+    }
+
+    size_t PushBack(T&& elem) {
+        return EmplaceBack(std::move(elem));
+    }
+
+    // Appends count copies of elem as one contiguous run and returns the index of the first
+    size_t GrowBy(size_t count, const T& elem = T()) {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "GrowBy copies elements after taking their indices");
+
+        size_t first = size_.fetch_add(count, std::memory_order_acq_rel);
+        for (size_t idx = first; idx < first + count; ++idx)
+            new (&SlotForWrite(idx)) T(elem);
+        return first;
+    }
+
+    // Destroys the elements but keeps the segments
+    void Clear() {
+        size_t size = size_.load(std::memory_order_relaxed);
+        for (size_t idx = 0; idx < size; ++idx)
+            Slot(idx).~T();
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    // Segment k holds kFirstSegmentSize << k elements starting at kFirstSegmentSize * (2^k - 1),
+    // so idx + kFirstSegmentSize has its highest bit at position k + kFirstSegmentBits
+    static constexpr size_t kFirstSegmentBits = 3;
+    static constexpr size_t kFirstSegmentSize = static_cast<size_t>(1) << kFirstSegmentBits;
+    static constexpr size_t kSegments = 64 - kFirstSegmentBits;
+
+    static size_t SegmentOf(size_t idx) {
+        return static_cast<size_t>(63 - __builtin_clzll(idx + kFirstSegmentSize)) - kFirstSegmentBits;
+    }
+
+    static size_t SegmentStart(size_t segment) {
+        return kFirstSegmentSize * ((static_cast<size_t>(1) << segment) - 1);
+    }
+
+    static size_t SegmentSize(size_t segment) {
+        return kFirstSegmentSize << segment;
+    }
+
+    static T* Allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    static void Deallocate(T* data, size_t count) {
+        ::operator delete(data, count * sizeof(T), std::align_val_t(alignof(T)));
+    }
+
+    T& Slot(size_t idx) const {
+        size_t segment = SegmentOf(idx);
+        return segments_[segment].load(std::memory_order_acquire)[idx - SegmentStart(segment)];
+    }
+
+    // Once an index is taken there is no way back, see the comment on the class
+    T& SlotForWrite(size_t idx) noexcept {
+        size_t segment = SegmentOf(idx);
+        return EnsureSegment(segment)[idx - SegmentStart(segment)];
+    }
+
+    // Whoever finds the segment missing allocates it; of several racing threads
+    // one publishes its block and the others free theirs
+    T* EnsureSegment(size_t segment) {
+        T* data = segments_[segment].load(std::memory_order_acquire);
+        if (data != nullptr)
+            return data;
+
+        T* allocated = Allocate(SegmentSize(segment));
+        if (segments_[segment].compare_exchange_strong(data, allocated, std::memory_order_acq_rel))
+            return allocated;
+
+        Deallocate(allocated, SegmentSize(segment));
+        return data;
+    }
+
+    std::atomic<size_t> size_{0};
+    std::atomic<T*> segments_[kSegments] = {};
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// Growth policies decide how much room Vector takes when an insertion doesn't fit.
+// A policy is any type with
+//     static size_t NextCapacity(size_t capacity, size_t required, size_t elem_size);
+// returning a capacity of at least required elements.
+// It may also have a member OnReallocation(old_capacity, new_capacity, bytes_moved),
+// which Vector calls after every change of its buffer.
+
+// Multiplies the capacity by Num / Den
+template <size_t Num, size_t Den>
+struct GeometricGrowth {
+    static_assert(Num > Den, "Growth factor must be greater than 1");
+
+    static size_t NextCapacity(size_t capacity, size_t required, size_t) {
+        return std::max({required, capacity * Num / Den, capacity + 1});
+    }
+};
+
+using DoublingGrowth = GeometricGrowth<2, 1>;
+using OneAndHalfGrowth = GeometricGrowth<3, 2>;
+
+// Extends the capacity of Base so that the buffer fills whole pages: for big
+// buffers the tail of the last page is wasted anyway.
+template <typename Base = DoublingGrowth, size_t PageSize = 4096>
+struct PageRoundedGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t elem_size) {
+        size_t bytes = Base::NextCapacity(capacity, required, elem_size) * elem_size;
+        bytes = (bytes + PageSize - 1) / PageSize * PageSize;
+        return bytes / elem_size;
+    }
+};
+
+// Extends the capacity of Base up to the size class malloc will serve the request
+// from anyway: multiples of 16 bytes for small blocks, then four classes per power
+// of two, like jemalloc and tcmalloc do.
+template <typename Base = DoublingGrowth>
+struct SizeClassGrowth {
+    static size_t NextCapacity(size_t capacity, size_t required, size_t elem_size) {
+        size_t bytes = Base::NextCapacity(capacity, required, elem_size) * elem_size;
+        return SizeClass(bytes) / elem_size;
+    }
+
+    static size_t SizeClass(size_t bytes) {
+        size_t spacing = 16;
+        if (bytes > 128) {
+            size_t power = 1;
+            while (power < bytes)
+                power <<= 1;
+            // bytes is in (power / 2, power], split it into four classes
+            spacing = power / 8;
+        }
+        return (bytes + spacing - 1) / spacing * spacing;
+    }
+};
+
+// Wraps another policy and records how the vector reallocated
+template <typename Base = DoublingGrowth>
+class CountingGrowth {
+public:
+    static size_t NextCapacity(size_t capacity, size_t required, size_t elem_size) {
+        return Base::NextCapacity(capacity, required, elem_size);
+    }
+
+    void OnReallocation(size_t, size_t new_capacity, size_t bytes_moved) {
+        ++reallocations_;
+        bytes_moved_ += bytes_moved;
+        peak_capacity_ = std::max(peak_capacity_, new_capacity);
+    }
+
+    size_t Reallocations() const {
+        return reallocations_;
+    }
+
+    size_t BytesMoved() const {
+        return bytes_moved_;
+    }
+
+    size_t PeakCapacity() const {
+        return peak_capacity_;
+    }
+
+private:
+    size_t reallocations_ = 0;
+    size_t bytes_moved_ = 0;
+    size_t peak_capacity_ = 0;
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "vector.hpp"
+
+// Allocator that takes every block straight from the kernel as anonymous pages.
+// On Linux blocks are resized with mremap, which moves page table entries instead
+// of bytes, so a Vector of trivially relocatable T grows in O(pages) and never
+// holds the old and the new copy of its data at once.
+template <typename T>
+class MmapAllocator {
+public:
+    using value_type = T;
+
+    MmapAllocator() = default;
+
+    template <typename U>
+    MmapAllocator(const MmapAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        void* ptr = mmap(nullptr, MappingSize(count), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            throw std::bad_alloc();
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t count) {
+        munmap(ptr, MappingSize(count));
+    }
+
+#ifdef __linux__
+    T* reallocate(T* ptr, size_t old_count, size_t count) {
+        void* new_ptr = mremap(ptr, MappingSize(old_count), MappingSize(count), MREMAP_MAYMOVE);
+        if (new_ptr == MAP_FAILED)
+            throw std::bad_alloc();
+        return static_cast<T*>(new_ptr);
+    }
+#endif
+
+    template <typename U>
+    bool operator==(const MmapAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const MmapAllocator<U>&) const {
+        return false;
+    }
+
+private:
+    static size_t MappingSize(size_t count) {
+        static const size_t kPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return (count * sizeof(T) + kPageSize - 1) / kPageSize * kPageSize;
+    }
+};
+
+// Vector for buffers of hundreds of megabytes and more. Small vectors waste
+// a whole page each, so use it only where the data is really big.
+template <typename T>
+using HugeVector = Vector<T, MmapAllocator<T>>;
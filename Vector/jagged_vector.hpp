@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "vector.hpp"
+
+// A vector of rows of T, like Vector<Vector<T>>, kept in one buffer: every row is a
+// contiguous range of data_ and rows_ holds where it starts, its size and its capacity.
+// There is no heap block per row, and rows appended one after another are adjacent,
+// so scanning all rows reads memory in order.
+//
+// A row may have slack, slots after its size that PushBackToRow fills in place. FromCounts
+// builds rows with exactly the room a counting pass asked for. A row that runs out of slack
+// is extended where it is if it ends the buffer, and moved to the end with twice the room
+// otherwise; the slots it leaves stay unused until ShrinkToFit packs the rows again.
+// Slots past a row's size hold default constructed values.
+template <typename T>
+class JaggedVector {
+
+public:
+
+using ValueType = T;
+using SizeType = size_t;
+using RowType = std::span<T>;
+using ConstRowType = std::span<const T>;
+
+static constexpr size_t kMinRowCapacity = 4;
+// Row sizes are stored in 32 bits
+static constexpr size_t kMaxRowSize = UINT32_MAX;
+
+
+//------------------------------constructors------------------------------
+
+    JaggedVector() = default;
+
+    JaggedVector(std::initializer_list<std::initializer_list<T>> rows) {
+        size_t elements = 0;
+        for (const auto& row : rows)
+            elements += row.size();
+        Reserve(rows.size(), elements);
+
+        for (const auto& row : rows)
+            AppendRow(row.begin(), row.end());
+    }
+
+    // Empty rows, row i with room for counts[i] elements: the second pass of a
+    // count-then-fill build, which then never moves a row
+    static JaggedVector FromCounts(std::span<const size_t> counts) {
+        JaggedVector jagged;
+        size_t elements = 0;
+        for (size_t count : counts)
+            elements += CheckRowSize(count);
+        jagged.rows_.Reserve(counts.size());
+        jagged.data_.Resize(elements);
+
+        size_t begin = 0;
+        for (size_t count : counts) {
+            jagged.rows_.PushBack(Extent{begin, 0, static_cast<uint32_t>(count)});
+            begin += count;
+        }
+        return jagged;
+    }
+
+//-----------------------------operators--------------------------------
+
+    RowType operator[](size_t row) {
+        const Extent& extent = rows_[row];
+        return RowType(data_.Data() + extent.begin, extent.size);
+    }
+
+    ConstRowType operator[](size_t row) const {
+        const Extent& extent = rows_[row];
+        return ConstRowType(data_.Data() + extent.begin, extent.size);
+    }
+
+//-----------------------------methods----------------------------------
+
+    RowType At(size_t row) {
+        CheckRow(row);
+        return (*this)[row];
+    }
+
+    ConstRowType At(size_t row) const {
+        CheckRow(row);
+        return (*this)[row];
+    }
+
+    // Number of rows
+    size_t Size() const {
+        return rows_.Size();
+    }
+
+    bool Empty() const {
+        return rows_.Empty();
+    }
+
+    // Number of elements in all rows
+    size_t ElementCount() const {
+        return elements_;
+    }
+
+    size_t RowSize(size_t row) const {
+        return rows_[row].size;
+    }
+
+    size_t RowCapacity(size_t row) const {
+        return rows_[row].capacity;
+    }
+
+    // Bytes allocated for elements and row headers, slack and unused slots included
+    size_t MemoryBytes() const {
+        return data_.Capacity() * sizeof(T) + rows_.Capacity() * sizeof(Extent);
+    }
+
+    template <typename InputIt>
+    void AppendRow(InputIt begin, InputIt end) {
+        size_t row_begin = data_.Size();
+        try {
+            for (; begin != end; ++begin)
+                data_.PushBack(*begin);
+            size_t size = CheckRowSize(data_.Size() - row_begin);
+            rows_.PushBack(Extent{row_begin, static_cast<uint32_t>(size), static_cast<uint32_t>(size)});
+        } catch (...) {
+            data_.Resize(row_begin);
+            throw;
+        }
+        elements_ += data_.Size() - row_begin;
+    }
+
+    void AppendRow(std::initializer_list<T> row) {
+        AppendRow(row.begin(), row.end());
+    }
+
+    void AppendRow(ConstRowType row) {
+        // A row of this vector would move away while data_ grows
+        std::less_equal<const T*> less_equal;
+        if (less_equal(data_.Data(), row.data()) && less_equal(row.data(), data_.Data() + data_.Size())) {
+            Vector<T> copy(row.begin(), row.end());
+            AppendRow(copy.begin(), copy.end());
+            return;
+        }
+        AppendRow(row.begin(), row.end());
+    }
+
+    void AppendEmptyRow(size_t capacity = 0) {
+        CheckRowSize(capacity);
+        size_t begin = data_.Size();
+        AppendSlots(capacity);
+        try {
+            rows_.PushBack(Extent{begin, 0, static_cast<uint32_t>(capacity)});
+        } catch (...) {
+            data_.Resize(begin);
+            throw;
+        }
+    }
+
+    // value is taken by value: growing the row may move the buffer it came from
+    void PushBackToRow(size_t row, T value) {
+        if (rows_[row].size == rows_[row].capacity)
+            GrowRow(row, rows_[row].size + size_t(1));
+
+        Extent& extent = rows_[row];
+        data_[extent.begin + extent.size] = std::move(value);
+        ++extent.size;
+        ++elements_;
+    }
+
+    void PopBackFromRow(size_t row) {
+        Extent& extent = rows_[row];
+        if (extent.size == 0)
+            return;
+
+        --extent.size;
+        --elements_;
+        data_[extent.begin + extent.size] = T();
+    }
+
+    // Makes room for capacity elements in the row, moving it if it has to grow
+    void ReserveRow(size_t row, size_t capacity) {
+        if (capacity > rows_[row].capacity)
+            GrowRow(row, capacity);
+    }
+
+    void ClearRow(size_t row) {
+        Extent& extent = rows_[row];
+        std::fill(data_.Data() + extent.begin, data_.Data() + extent.begin + extent.size, T());
+        elements_ -= extent.size;
+        extent.size = 0;
+    }
+
+    void Reserve(size_t rows, size_t elements) {
+        rows_.Reserve(rows);
+        data_.Reserve(elements);
+    }
+
+    void Clear() {
+        rows_.Clear();
+        data_.Clear();
+        elements_ = 0;
+    }
+
+    // Packs the rows in order without slack, leaving offsets and data as flat as after
+    // appending every row once
+    void ShrinkToFit() {
+        Vector<T> packed;
+        packed.Reserve(elements_);
+        for (const Extent& extent : rows_) {
+            for (size_t i = 0; i < extent.size; ++i)
+                packed.PushBack(std::move_if_noexcept(data_[extent.begin + i]));
+        }
+
+        size_t begin = 0;
+        for (Extent& extent : rows_) {
+            extent.begin = begin;
+            extent.capacity = extent.size;
+            begin += extent.size;
+        }
+        data_.Swap(packed);
+        rows_.ShrinkToFit();
+    }
+
+    void Swap(JaggedVector& other) noexcept {
+        rows_.Swap(other.rows_);
+        data_.Swap(other.data_);
+        std::swap(elements_, other.elements_);
+    }
+
+private:
+    struct Extent {
+        size_t begin;
+        uint32_t size;
+        uint32_t capacity;
+    };
+
+    static size_t CheckRowSize(size_t size) {
+        if (size > kMaxRowSize)
+            throw std::length_error("Row too long");
+        return size;
+    }
+
+    void CheckRow(size_t row) const {
+        if (row >= rows_.Size())
+            throw std::out_of_range("Out of range");
+    }
+
+    // Appends count default constructed slots, growing data_ geometrically:
+    // Resize alone allocates exactly the new size
+    void AppendSlots(size_t count) {
+        size_t size = data_.Size();
+        if (data_.Capacity() < size + count)
+            data_.Reserve(std::max(size + count, 2 * data_.Capacity()));
+        data_.Resize(size + count);
+    }
+
+    void GrowRow(size_t row, size_t needed) {
+        Extent extent = rows_[row];
+        size_t capacity = CheckRowSize(std::max({needed, 2 * size_t(extent.capacity), kMinRowCapacity}));
+
+        if (extent.begin + extent.capacity == data_.Size()) {
+            // The last row in the buffer grows where it is
+            AppendSlots(capacity - extent.capacity);
+        } else {
+            size_t begin = data_.Size();
+            AppendSlots(capacity);
+            try {
+                for (size_t i = 0; i < extent.size; ++i)
+                    data_[begin + i] = std::move_if_noexcept(data_[extent.begin + i]);
+            } catch (...) {
+                data_.Resize(begin);
+                throw;
+            }
+            std::fill(data_.Data() + extent.begin, data_.Data() + extent.begin + extent.size, T());
+            rows_[row].begin = begin;
+        }
+        rows_[row].capacity = static_cast<uint32_t>(capacity);
+    }
+
+    Vector<Extent> rows_;
+    Vector<T> data_;
+    size_t elements_ = 0;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+
+// Allocator on top of malloc/free. Unlike std::allocator it can resize a block with
+// realloc, which Vector uses to grow trivially relocatable elements without copying
+// them whenever the heap has room right after the block.
+template <typename T>
+class MallocAllocator {
+public:
+    using value_type = T;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc can't provide the alignment of T");
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        void* ptr = std::malloc(count * sizeof(T));
+        if (ptr == nullptr)
+            throw std::bad_alloc();
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_t) {
+        std::free(ptr);
+    }
+
+    T* reallocate(T* ptr, size_t, size_t count) {
+        void* new_ptr = std::realloc(ptr, count * sizeof(T));
+        if (new_ptr == nullptr)
+            throw std::bad_alloc();
+        return static_cast<T*>(new_ptr);
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>&) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const MallocAllocator<U>&) const {
+        return false;
+    }
+};
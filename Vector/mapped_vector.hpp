@@ -0,0 +1,375 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+
+#include "growth_policy.hpp"
+
+// Vector whose elements are the contents of a file, mapped into memory: opening
+// a file of any size takes a few system calls, and the pages are read on first access.
+// The file is a plain array of T with nothing else in it.
+//
+// While the vector is open for writing the file is as long as the capacity; Sync,
+// ShrinkToFit and the destructor cut it back to the elements. A vector opened read-only
+// maps the file shared, so every process reading it uses the same page cache, and
+// its modifiers throw std::logic_error.
+template <typename T, typename Growth = PageRoundedGrowth<>>
+class MappedVector {
+
+static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores its elements as raw bytes");
+
+public:
+
+using ValueType = T;
+using Pointer = T*;
+using ConstPointer = const T*;
+using Reference = T&;
+using ConstReference = const T&;
+using SizeType = size_t;
+using Iterator = T*;
+using ConstIterator = const T*;
+using ReverseIterator = std::reverse_iterator<Iterator>;
+using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+enum class Mode {
+    kReadWrite,
+    kReadOnly,
+};
+
+
+//------------------------------constructors------------------------------
+
+    // Opens path, creating an empty file if it doesn't exist and the mode allows writing
+    explicit MappedVector(const std::string& path, Mode mode = Mode::kReadWrite) : mode_(mode) {
+        fd_ = mode == Mode::kReadOnly ? open(path.c_str(), O_RDONLY | O_CLOEXEC)
+                                      : open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0)
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+
+        try {
+            struct stat st;
+            if (fstat(fd_, &st) != 0)
+                throw std::system_error(errno, std::generic_category(), "fstat " + path);
+            if (static_cast<size_t>(st.st_size) % sizeof(T) != 0)
+                throw std::runtime_error(path + " is not an array of whole elements");
+
+            size_ = static_cast<size_t>(st.st_size) / sizeof(T);
+            data_ = Map(size_);
+            capacity_ = size_;
+        }
+        catch (...) {
+            close(fd_);
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : data_(other.data_), size_(other.size_), capacity_(other.capacity_), fd_(other.fd_), mode_(other.mode_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+        other.fd_ = -1;
+    }
+
+//-----------------------------destructor--------------------------------
+
+    ~MappedVector() {
+        Close();
+    }
+
+//-----------------------------iterators--------------------------------
+
+    Iterator begin() {
+        return data_;
+    }
+
+    ConstIterator begin() const {
+        return data_;
+    }
+
+    Iterator end() {
+        return data_ + size_;
+    }
+
+    ConstIterator end() const {
+        return data_ + size_;
+    }
+
+    ConstIterator cbegin() const {
+        return data_;
+    }
+
+    ConstIterator cend() const {
+        return data_ + size_;
+    }
+
+    ReverseIterator rbegin() {
+        return std::reverse_iterator(end());
+    }
+
+    ConstReverseIterator rbegin() const {
+        return std::reverse_iterator(end());
+    }
+
+    ConstReverseIterator crbegin() const {
+        return rbegin();
+    }
+
+    ReverseIterator rend() {
+        return std::reverse_iterator(begin());
+    }
+
+    ConstReverseIterator rend() const {
+        return std::reverse_iterator(begin());
+    }
+
+    ConstReverseIterator crend() const {
+        return rend();
+    }
+
+//-----------------------------operators--------------------------------
+
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector& operator=(MappedVector&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        Close();
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        fd_ = other.fd_;
+        mode_ = other.mode_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+        other.fd_ = -1;
+
+        return *this;
+    }
+
+    // Elements of a read-only vector must not be written through the returned reference
+    T& operator[](size_t idx) {
+        return data_[idx];
+    }
+
+    const T& operator[](size_t idx) const {
+        return data_[idx];
+    }
+
+//-----------------------------methods----------------------------------
+
+    T* Data() {
+        return data_;
+    }
+
+    const T* Data() const {
+        return data_;
+    }
+
+    T& Front() {
+        return data_[0];
+    }
+
+    const T& Front() const {
+        return data_[0];
+    }
+
+    T& Back() {
+        return data_[size_ - 1];
+    }
+
+    const T& Back() const {
+        return data_[size_ - 1];
+    }
+
+    T& At(size_t idx) {
+        if (idx >= size_)
+            throw std::out_of_range("Out of range");
+        return data_[idx];
+    }
+
+    const T& At(size_t idx) const {
+        if (idx >= size_)
+            throw std::out_of_range("Out of range");
+        return data_[idx];
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    bool IsReadOnly() const {
+        return mode_ == Mode::kReadOnly;
+    }
+
+    void Clear() {
+        Resize(0);
+    }
+
+    // New elements are zero bytes
+    void Resize(size_t size) {
+        CheckWritable();
+        if (size > capacity_)
+            Remap(size);
+        if (size > size_)
+            std::memset(static_cast<void*>(data_ + size_), 0, (size - size_) * sizeof(T));
+        size_ = size;
+    }
+
+    void Resize(size_t size, const T& elem) {
+        CheckWritable();
+        if (size > capacity_) {
+            T copy = elem;
+            Remap(size);
+            std::fill(data_ + size_, data_ + size, copy);
+        } else if (size > size_) {
+            std::fill(data_ + size_, data_ + size, elem);
+        }
+        size_ = size;
+    }
+
+    void Reserve(size_t capacity) {
+        CheckWritable();
+        if (capacity_ >= capacity)
+            return;
+
+        Remap(capacity);
+    }
+
+    void ShrinkToFit() {
+        CheckWritable();
+        if (capacity_ == size_)
+            return;
+
+        Remap(size_);
+    }
+
+    template<typename... Args>
+    void EmplaceBack(Args&&... args) {
+        PushBack(T(std::forward<Args>(args)...));
+    }
+
+    void PushBack(const T& elem) {
+        CheckWritable();
+        if (size_ == capacity_) {
+            T copy = elem;
+            Remap(std::max(size_ + 1, Growth::NextCapacity(capacity_, size_ + 1, sizeof(T))));
+            data_[size_++] = copy;
+            return;
+        }
+
+        data_[size_++] = elem;
+    }
+
+    template<typename InputIterator,
+    typename = typename std::iterator_traits<InputIterator>::iterator_category>
+    void AppendRange(InputIterator first, InputIterator last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                      typename std::iterator_traits<InputIterator>::iterator_category>) {
+            size_t required = size_ + static_cast<size_t>(std::distance(first, last));
+            if (required > capacity_)
+                Reserve(std::max(required, Growth::NextCapacity(capacity_, required, sizeof(T))));
+        }
+        for (; first != last; ++first)
+            PushBack(*first);
+    }
+
+    void PopBack() {
+        CheckWritable();
+        if (size_ > 0)
+            size_--;
+    }
+
+    // Cuts the file to the elements and waits until they are on disk
+    void Sync() {
+        CheckWritable();
+        ShrinkToFit();
+        if (data_ != nullptr && msync(data_, size_ * sizeof(T), MS_SYNC) != 0)
+            throw std::system_error(errno, std::generic_category(), "msync");
+        if (fsync(fd_) != 0)
+            throw std::system_error(errno, std::generic_category(), "fsync");
+    }
+
+private:
+    void CheckWritable() const {
+        if (mode_ == Mode::kReadOnly)
+            throw std::logic_error("MappedVector is read-only");
+    }
+
+    T* Map(size_t capacity) {
+        if (capacity == 0)
+            return nullptr;
+
+        int protection = mode_ == Mode::kReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* ptr = mmap(nullptr, capacity * sizeof(T), protection, MAP_SHARED, fd_, 0);
+        if (ptr == MAP_FAILED)
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        return static_cast<T*>(ptr);
+    }
+
+    // Sets the length of the file to capacity elements and maps all of it
+    void Remap(size_t capacity) {
+        if (ftruncate(fd_, static_cast<off_t>(capacity * sizeof(T))) != 0)
+            throw std::system_error(errno, std::generic_category(), "ftruncate");
+
+#ifdef __linux__
+        if (data_ != nullptr && capacity > 0) {
+            void* ptr = mremap(data_, capacity_ * sizeof(T), capacity * sizeof(T), MREMAP_MAYMOVE);
+            if (ptr == MAP_FAILED)
+                throw std::system_error(errno, std::generic_category(), "mremap");
+            data_ = static_cast<T*>(ptr);
+            capacity_ = capacity;
+            return;
+        }
+#endif
+
+        // Both mappings show the same file, so nothing has to be copied
+        T* new_data = Map(capacity);
+        if (data_ != nullptr)
+            munmap(data_, capacity_ * sizeof(T));
+        data_ = new_data;
+        capacity_ = capacity;
+    }
+
+    void Close() {
+        if (fd_ < 0)
+            return;
+
+        if (data_ != nullptr)
+            munmap(data_, capacity_ * sizeof(T));
+        if (mode_ == Mode::kReadWrite && capacity_ != size_)
+            (void)ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T)));
+        close(fd_);
+        data_ = nullptr;
+        fd_ = -1;
+    }
+
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    int fd_ = -1;
+    Mode mode_;
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Opt-in for the parallel overloads of Vector: ranges of at least threshold elements
+// are split into chunks that run on the shared thread pool
+struct ParallelExecution {
+    size_t threshold = 1 << 16;
+    // 0 means one chunk per hardware thread
+    size_t threads = 0;
+};
+
+// Fixed set of worker threads, created on first use and shared by all vectors
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t workers) {
+        for (size_t i = 0; i < workers; ++i)
+            workers_.emplace_back([this] { Work(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        wakeup_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    // The calling thread works too, so one worker less than there are cores,
+    // but at least one to have any parallelism
+    static ThreadPool& Instance() {
+        static ThreadPool pool(std::max(HardwareThreads(), static_cast<size_t>(2)) - 1);
+        return pool;
+    }
+
+    static size_t HardwareThreads() {
+        return std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1));
+    }
+
+    size_t Size() const {
+        return workers_.size();
+    }
+
+    void Submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push(std::move(task));
+        }
+        wakeup_.notify_one();
+    }
+
+private:
+    void Work() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wakeup_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+                if (tasks_.empty())
+                    return;
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool stopped_ = false;
+};
+
+// Calls func(begin, end) for consecutive chunks of [0, count), in parallel when count
+// reaches exec.threshold. The calling thread claims chunks as well and waits only for
+// the ones already running, so nested calls can't deadlock the pool.
+// If some chunks throw, undo(begin, end) is called for every chunk that succeeded
+// and the first exception is rethrown: func has to clean up its own chunk itself.
+template <typename Func, typename Undo>
+void ParallelFor(size_t count, const ParallelExecution& exec, Func&& func, Undo&& undo) {
+    size_t threads = exec.threads > 0 ? exec.threads : ThreadPool::HardwareThreads();
+    if (count < exec.threshold || count < 2 || threads < 2) {
+        func(static_cast<size_t>(0), count);
+        return;
+    }
+
+    size_t chunk_size = (count + std::min(threads, count) - 1) / std::min(threads, count);
+    size_t chunks = (count + chunk_size - 1) / chunk_size;
+
+    struct Job {
+        std::atomic<size_t> next{0};
+        size_t finished = 0;
+        std::vector<std::exception_ptr> errors;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto job = std::make_shared<Job>();
+    job->errors.resize(chunks);
+
+    // A worker may get to the job after all chunks are claimed and the caller
+    // returned, then it touches only the job it shares
+    auto run = [job, chunks, chunk_size, count, &func] {
+        for (size_t chunk = job->next++; chunk < chunks; chunk = job->next++) {
+            size_t begin = chunk * chunk_size;
+            try {
+                func(begin, std::min(count, begin + chunk_size));
+            }
+            catch (...) {
+                job->errors[chunk] = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (++job->finished == chunks)
+                job->done.notify_all();
+        }
+    };
+
+    ThreadPool& pool = ThreadPool::Instance();
+    for (size_t i = 0; i < std::min(chunks - 1, pool.Size()); ++i)
+        pool.Submit(run);
+    run();
+
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->done.wait(lock, [&job, chunks] { return job->finished == chunks; });
+    }
+
+    std::exception_ptr error;
+    for (size_t chunk = 0; chunk < chunks && !error; ++chunk)
+        error = job->errors[chunk];
+    if (!error)
+        return;
+
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        if (!job->errors[chunk]) {
+            size_t begin = chunk * chunk_size;
+            undo(begin, std::min(count, begin + chunk_size));
+        }
+    }
+    std::rethrow_exception(error);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+#include "parallel.hpp"
+#include "vector.hpp"
+
+// Parallel counterparts of the Vector constructors, Resize and Fill, see ParallelExecution.
+// They live apart from vector.hpp so that only code including this header pulls in the
+// thread pool. The allocator's construct is called from several threads at once.
+
+struct ParallelVectorAccess {
+    // Builds size copies of elem into a new buffer of exactly that size, v must be empty
+    template <typename T, typename Alloc, typename Growth>
+    static void ConstructFill(Vector<T, Alloc, Growth>& v, size_t size, const T& elem, const ParallelExecution& exec) {
+        T* data = v.Allocate(size);
+        try {
+            FillUninitialized(v, data, size, elem, exec);
+        }
+        catch (...) {
+            v.Deallocate(data, size);
+            throw;
+        }
+        v.data_ = data;
+        v.size_ = size;
+        v.capacity_ = size;
+    }
+
+    // Same for the range [first, first + size)
+    template <typename T, typename Alloc, typename Growth, typename RandomAccessIterator>
+    static void ConstructRange(Vector<T, Alloc, Growth>& v, RandomAccessIterator first, size_t size,
+                               const ParallelExecution& exec) {
+        T* data = v.Allocate(size);
+        try {
+            ParallelFor(size, exec, [&v, data, first](size_t begin, size_t end) {
+                v.ConstructRange(data + begin, first + begin, end - begin);
+            }, [&v, data](size_t begin, size_t end) {
+                v.DestroyRange(data + begin, data + end);
+            });
+        }
+        catch (...) {
+            v.Deallocate(data, size);
+            throw;
+        }
+        v.data_ = data;
+        v.size_ = size;
+        v.capacity_ = size;
+    }
+
+    // Appends count copies of elem like Resize does: elem may live in v, and if a copy
+    // throws, v is left as it was
+    template <typename T, typename Alloc, typename Growth>
+    static void AppendFill(Vector<T, Alloc, Growth>& v, size_t count, const T& elem, const ParallelExecution& exec) {
+        v.AppendExact(count, [&v, count, &elem, &exec](T* place) {
+            FillUninitialized(v, place, count, elem, exec);
+        });
+    }
+
+private:
+    template <typename T, typename Alloc, typename Growth>
+    static void FillUninitialized(Vector<T, Alloc, Growth>& v, T* dest, size_t count, const T& elem,
+                                  const ParallelExecution& exec) {
+        ParallelFor(count, exec, [&v, dest, &elem](size_t begin, size_t end) {
+            v.ConstructFill(dest + begin, end - begin, elem);
+        }, [&v, dest](size_t begin, size_t end) {
+            v.DestroyRange(dest + begin, dest + end);
+        });
+    }
+};
+
+// Vector(size, elem), with the copies made in parallel
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
+Vector<T, Alloc, Growth> MakeParallel(size_t size, const T& elem, const ParallelExecution& exec,
+                                      const Alloc& alloc = Alloc()) {
+    Vector<T, Alloc, Growth> v(alloc);
+    ParallelVectorAccess::ConstructFill(v, size, elem, exec);
+    return v;
+}
+
+// Vector(begin, end) for random access iterators, with the elements copied in parallel
+template <typename RandomAccessIterator,
+          typename Alloc = std::allocator<typename std::iterator_traits<RandomAccessIterator>::value_type>,
+          typename = typename std::iterator_traits<RandomAccessIterator>::iterator_category>
+Vector<typename std::iterator_traits<RandomAccessIterator>::value_type, Alloc> MakeParallel(
+    RandomAccessIterator begin, RandomAccessIterator end, const ParallelExecution& exec, const Alloc& alloc = Alloc()) {
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                  typename std::iterator_traits<RandomAccessIterator>::iterator_category>,
+                  "Parallel construction needs random access iterators");
+
+    Vector<typename std::iterator_traits<RandomAccessIterator>::value_type, Alloc> v(alloc);
+    ParallelVectorAccess::ConstructRange(v, begin, static_cast<size_t>(std::distance(begin, end)), exec);
+    return v;
+}
+
+// Copy of other, with the elements copied in parallel
+template <typename T, typename Alloc, typename Growth>
+Vector<T, Alloc, Growth> MakeParallel(const Vector<T, Alloc, Growth>& other, const ParallelExecution& exec) {
+    Vector<T, Alloc, Growth> v(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.GetAllocator()));
+    ParallelVectorAccess::ConstructRange(v, other.begin(), other.Size(), exec);
+    return v;
+}
+
+// v.Resize(size, elem), with the new elements built in parallel
+template <typename T, typename Alloc, typename Growth>
+void ParallelResize(Vector<T, Alloc, Growth>& v, size_t size,
+                    const typename Vector<T, Alloc, Growth>::ValueType& elem, const ParallelExecution& exec) {
+    if (size <= v.Size()) {
+        v.Resize(size, elem);
+        return;
+    }
+
+    ParallelVectorAccess::AppendFill(v, size - v.Size(), elem, exec);
+}
+
+// v.Fill(elem) in parallel. If an assignment throws, the elements are left partly assigned.
+template <typename T, typename Alloc, typename Growth>
+void ParallelFill(Vector<T, Alloc, Growth>& v, const typename Vector<T, Alloc, Growth>::ValueType& elem,
+                  const ParallelExecution& exec) {
+    T* data = v.Data();
+    ParallelFor(v.Size(), exec, [data, &elem](size_t begin, size_t end) {
+        std::fill(data + begin, data + end, elem);
+    }, [](size_t, size_t) {});
+}
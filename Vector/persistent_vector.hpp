@@ -0,0 +1,505 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "vector.hpp"
+
+// Immutable vector whose versions share structure, so that keeping a snapshot is O(1).
+//
+// Elements live in leaves of 32 in a 32-way trie, plus a tail leaf of up to 32 elements
+// kept outside the trie so that PushBack usually touches only the tail. Set, PushBack and
+// PopBack leave the vector as it is and return a new version, which copies the O(log32 n)
+// nodes on the path to the changed element and shares the rest. All versions may be read
+// from any number of threads at once.
+//
+// For many updates in a row take a Transient: it edits the nodes it has already copied in
+// place, so a batch of PushBacks costs about as much as with Vector.
+template <typename T>
+class PersistentVector {
+
+static constexpr size_t kBits = 5;
+static constexpr size_t kWidth = static_cast<size_t>(1) << kBits;
+static constexpr size_t kMask = kWidth - 1;
+
+// Nodes remember the transient that created them; only that transient may change them
+struct Node {
+    uint64_t owner = 0;
+};
+
+struct Branch : Node {
+    std::shared_ptr<Node> children[kWidth];
+};
+
+struct Leaf : Node {
+    Vector<T> values;
+};
+
+using NodePtr = std::shared_ptr<Node>;
+
+public:
+
+using ValueType = T;
+using ConstReference = const T&;
+using SizeType = size_t;
+
+class ConstIterator;
+class Transient;
+
+
+//------------------------------constructors------------------------------
+
+    PersistentVector() : root_(MakeBranch(0)), tail_(MakeLeaf(0)) {}
+
+    PersistentVector(std::initializer_list<T> list) : PersistentVector() {
+        Transient transient(*this);
+        for (const T& elem : list)
+            transient.PushBack(elem);
+        *this = transient.Persistent();
+    }
+
+    PersistentVector(const PersistentVector&) = default;
+
+    PersistentVector(PersistentVector&&) noexcept = default;
+
+//-----------------------------operators--------------------------------
+
+    PersistentVector& operator=(const PersistentVector&) = default;
+
+    PersistentVector& operator=(PersistentVector&&) noexcept = default;
+
+    const T& operator[](size_t idx) const {
+        return LeafFor(idx).values[idx & kMask];
+    }
+
+//-----------------------------iterators--------------------------------
+
+    ConstIterator begin() const {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const {
+        return begin();
+    }
+
+    ConstIterator cend() const {
+        return end();
+    }
+
+//-----------------------------methods----------------------------------
+
+    const T& At(size_t idx) const {
+        if (idx >= size_)
+            throw std::out_of_range("Out of range");
+        return (*this)[idx];
+    }
+
+    const T& Front() const {
+        return (*this)[0];
+    }
+
+    const T& Back() const {
+        return (*this)[size_ - 1];
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    // The vector with elem appended; this one stays as it was
+    [[nodiscard]] PersistentVector PushBack(const T& elem) const {
+        PersistentVector result(*this);
+        result.DoPushBack(elem, 0);
+        return result;
+    }
+
+    [[nodiscard]] PersistentVector PushBack(T&& elem) const {
+        PersistentVector result(*this);
+        result.DoPushBack(std::move(elem), 0);
+        return result;
+    }
+
+    [[nodiscard]] PersistentVector Set(size_t idx, const T& elem) const {
+        PersistentVector result(*this);
+        result.DoSet(idx, elem, 0);
+        return result;
+    }
+
+    [[nodiscard]] PersistentVector PopBack() const {
+        PersistentVector result(*this);
+        result.DoPopBack(0);
+        return result;
+    }
+
+    // A mutable copy for a batch of edits, taking the snapshot is O(1)
+    Transient AsTransient() const {
+        return Transient(*this);
+    }
+
+//------------------------------transient--------------------------------
+
+    // Edits in place the nodes it has copied since the last Persistent().
+    // Not thread safe, but the versions it gives out are.
+    class Transient {
+    public:
+        explicit Transient(const PersistentVector& vec) : vec_(vec), edit_(NextEditId()) {}
+
+        const T& operator[](size_t idx) const {
+            return vec_[idx];
+        }
+
+        size_t Size() const {
+            return vec_.Size();
+        }
+
+        bool Empty() const {
+            return vec_.Empty();
+        }
+
+        void PushBack(const T& elem) {
+            vec_.DoPushBack(elem, edit_);
+        }
+
+        void PushBack(T&& elem) {
+            vec_.DoPushBack(std::move(elem), edit_);
+        }
+
+        void Set(size_t idx, const T& elem) {
+            vec_.DoSet(idx, elem, edit_);
+        }
+
+        void PopBack() {
+            vec_.DoPopBack(edit_);
+        }
+
+        // The current contents as a persistent vector. The transient may be edited
+        // further, its next edits copy the nodes they touch once more.
+        PersistentVector Persistent() {
+            edit_ = NextEditId();
+            return vec_;
+        }
+
+    private:
+        PersistentVector vec_;
+        uint64_t edit_;
+    };
+
+//------------------------------iterator--------------------------------
+
+    // Remembers the leaf it points into, so stepping through a leaf costs no descent
+    class ConstIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        ConstIterator() = default;
+
+        ConstIterator(const PersistentVector* vec, size_t idx) : vec_(vec), idx_(idx) {}
+
+        const T& operator*() const {
+            size_t leaf_start = idx_ & ~kMask;
+            if (leaf_ == nullptr || leaf_start != leaf_start_) {
+                leaf_ = vec_->LeafFor(idx_).values.Data();
+                leaf_start_ = leaf_start;
+            }
+            return leaf_[idx_ & kMask];
+        }
+
+        const T* operator->() const {
+            return &**this;
+        }
+
+        const T& operator[](difference_type diff) const {
+            return *(*this + diff);
+        }
+
+        ConstIterator& operator++() {
+            ++idx_;
+            return *this;
+        }
+
+        ConstIterator operator++(int) {
+            auto copy = *this;
+            ++idx_;
+            return copy;
+        }
+
+        ConstIterator& operator--() {
+            --idx_;
+            return *this;
+        }
+
+        ConstIterator operator--(int) {
+            auto copy = *this;
+            --idx_;
+            return copy;
+        }
+
+        ConstIterator& operator+=(difference_type diff) {
+            idx_ = static_cast<size_t>(static_cast<difference_type>(idx_) + diff);
+            return *this;
+        }
+
+        ConstIterator& operator-=(difference_type diff) {
+            return *this += -diff;
+        }
+
+        ConstIterator operator+(difference_type diff) const {
+            auto copy = *this;
+            copy += diff;
+            return copy;
+        }
+
+        friend ConstIterator operator+(difference_type diff, const ConstIterator& it) {
+            return it + diff;
+        }
+
+        ConstIterator operator-(difference_type diff) const {
+            auto copy = *this;
+            copy -= diff;
+            return copy;
+        }
+
+        difference_type operator-(const ConstIterator& other) const {
+            return static_cast<difference_type>(idx_) - static_cast<difference_type>(other.idx_);
+        }
+
+        bool operator==(const ConstIterator& other) const {
+            return idx_ == other.idx_;
+        }
+
+        bool operator!=(const ConstIterator& other) const {
+            return idx_ != other.idx_;
+        }
+
+        bool operator<(const ConstIterator& other) const {
+            return idx_ < other.idx_;
+        }
+
+        bool operator>(const ConstIterator& other) const {
+            return idx_ > other.idx_;
+        }
+
+        bool operator<=(const ConstIterator& other) const {
+            return idx_ <= other.idx_;
+        }
+
+        bool operator>=(const ConstIterator& other) const {
+            return idx_ >= other.idx_;
+        }
+
+    private:
+        const PersistentVector* vec_ = nullptr;
+        size_t idx_ = 0;
+        mutable const T* leaf_ = nullptr;
+        mutable size_t leaf_start_ = 0;
+    };
+
+private:
+    // Edit 0 belongs to nobody: nodes are always copied before a change
+    static uint64_t NextEditId() {
+        static std::atomic<uint64_t> next_id{1};
+        return next_id.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static std::shared_ptr<Branch> MakeBranch(uint64_t edit) {
+        auto branch = std::make_shared<Branch>();
+        branch->owner = edit;
+        return branch;
+    }
+
+    static std::shared_ptr<Leaf> MakeLeaf(uint64_t edit) {
+        auto leaf = std::make_shared<Leaf>();
+        leaf->owner = edit;
+        leaf->values.Reserve(kWidth);
+        return leaf;
+    }
+
+    // The node itself if the edit owns it, otherwise a copy owned by the edit
+    static std::shared_ptr<Branch> EditableBranch(const NodePtr& node, uint64_t edit) {
+        auto branch = std::static_pointer_cast<Branch>(node);
+        if (edit != 0 && branch->owner == edit)
+            return branch;
+
+        auto copy = std::make_shared<Branch>(*branch);
+        copy->owner = edit;
+        return copy;
+    }
+
+    static std::shared_ptr<Leaf> EditableLeaf(const NodePtr& node, uint64_t edit) {
+        auto leaf = std::static_pointer_cast<Leaf>(node);
+        if (edit != 0 && leaf->owner == edit)
+            return leaf;
+
+        auto copy = MakeLeaf(edit);
+        for (const T& elem : leaf->values)
+            copy->values.PushBack(elem);
+        return copy;
+    }
+
+    // Index of the first element in the tail
+    size_t TailOffset() const {
+        return size_ < kWidth ? 0 : ((size_ - 1) >> kBits) << kBits;
+    }
+
+    const Leaf& LeafFor(size_t idx) const {
+        if (idx >= TailOffset())
+            return static_cast<const Leaf&>(*tail_);
+
+        const Node* node = root_.get();
+        for (size_t level = shift_; level > 0; level -= kBits)
+            node = static_cast<const Branch*>(node)->children[(idx >> level) & kMask].get();
+        return static_cast<const Leaf&>(*node);
+    }
+
+    template <typename U>
+    void DoPushBack(U&& elem, uint64_t edit) {
+        if (size_ - TailOffset() < kWidth) {
+            auto tail = EditableLeaf(tail_, edit);
+            tail->values.PushBack(std::forward<U>(elem));
+            tail_ = std::move(tail);
+            ++size_;
+            return;
+        }
+
+        // The tail is full and moves into the trie, elem starts a new one
+        auto tail = MakeLeaf(edit);
+        tail->values.PushBack(std::forward<U>(elem));
+
+        if ((size_ >> kBits) > (static_cast<size_t>(1) << shift_)) {
+            auto root = MakeBranch(edit);
+            root->children[0] = root_;
+            root->children[1] = NewPath(shift_, tail_, edit);
+            root_ = std::move(root);
+            shift_ += kBits;
+        } else {
+            root_ = PushTail(shift_, root_, edit);
+        }
+        tail_ = std::move(tail);
+        ++size_;
+    }
+
+    // A chain of single-child branches from level down to node
+    static NodePtr NewPath(size_t level, NodePtr node, uint64_t edit) {
+        if (level == 0)
+            return node;
+
+        auto branch = MakeBranch(edit);
+        branch->children[0] = NewPath(level - kBits, std::move(node), edit);
+        return branch;
+    }
+
+    NodePtr PushTail(size_t level, const NodePtr& node, uint64_t edit) const {
+        auto branch = EditableBranch(node, edit);
+        size_t sub = ((size_ - 1) >> level) & kMask;
+        if (level == kBits) {
+            branch->children[sub] = tail_;
+        } else if (branch->children[sub] != nullptr) {
+            branch->children[sub] = PushTail(level - kBits, branch->children[sub], edit);
+        } else {
+            branch->children[sub] = NewPath(level - kBits, tail_, edit);
+        }
+        return branch;
+    }
+
+    void DoSet(size_t idx, const T& elem, uint64_t edit) {
+        if (idx >= size_)
+            throw std::out_of_range("Out of range");
+
+        if (idx >= TailOffset()) {
+            auto tail = EditableLeaf(tail_, edit);
+            tail->values[idx & kMask] = elem;
+            tail_ = std::move(tail);
+            return;
+        }
+        root_ = SetInNode(shift_, root_, idx, elem, edit);
+    }
+
+    static NodePtr SetInNode(size_t level, const NodePtr& node, size_t idx, const T& elem, uint64_t edit) {
+        if (level == 0) {
+            auto leaf = EditableLeaf(node, edit);
+            leaf->values[idx & kMask] = elem;
+            return leaf;
+        }
+
+        auto branch = EditableBranch(node, edit);
+        size_t sub = (idx >> level) & kMask;
+        branch->children[sub] = SetInNode(level - kBits, branch->children[sub], idx, elem, edit);
+        return branch;
+    }
+
+    void DoPopBack(uint64_t edit) {
+        if (size_ == 0)
+            return;
+
+        if (size_ - TailOffset() > 1 || size_ == 1) {
+            auto tail = EditableLeaf(tail_, edit);
+            tail->values.PopBack();
+            tail_ = std::move(tail);
+            --size_;
+            return;
+        }
+
+        // The tail empties, the last leaf of the trie becomes the tail
+        NodePtr tail = LeafPtrFor(size_ - 2);
+        NodePtr root = PopTail(shift_, root_, edit);
+        if (root == nullptr)
+            root = MakeBranch(edit);
+        if (shift_ > kBits && static_cast<Branch&>(*root).children[1] == nullptr) {
+            root = static_cast<Branch&>(*root).children[0];
+            shift_ -= kBits;
+        }
+        root_ = std::move(root);
+        tail_ = std::move(tail);
+        --size_;
+    }
+
+    NodePtr LeafPtrFor(size_t idx) const {
+        NodePtr node = root_;
+        for (size_t level = shift_; level > 0; level -= kBits)
+            node = static_cast<const Branch&>(*node).children[(idx >> level) & kMask];
+        return node;
+    }
+
+    // The node without its last leaf, or nullptr if nothing is left in it
+    NodePtr PopTail(size_t level, const NodePtr& node, uint64_t edit) const {
+        size_t sub = ((size_ - 2) >> level) & kMask;
+        if (level > kBits) {
+            NodePtr child = PopTail(level - kBits, static_cast<const Branch&>(*node).children[sub], edit);
+            if (child == nullptr && sub == 0)
+                return nullptr;
+
+            auto branch = EditableBranch(node, edit);
+            branch->children[sub] = std::move(child);
+            return branch;
+        }
+        if (sub == 0)
+            return nullptr;
+
+        auto branch = EditableBranch(node, edit);
+        branch->children[sub] = nullptr;
+        return branch;
+    }
+
+    NodePtr root_;
+    NodePtr tail_;
+    size_t size_ = 0;
+    size_t shift_ = kBits;
+};
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#include "vector.hpp"
+
+// Whole-buffer algorithms for Vector of arithmetic types, vectorized with SSE2 and AVX2,
+// in namespace simd. The instruction set is picked at run time; every function takes
+// an optional level to cap it, which is how the tests and the benchmark compare the
+// implementations.
+// int32_t, float and double have SIMD kernels, other types run the scalar ones.
+//
+// Sum adds in a different order than a plain loop does, so float results may differ
+// in the last bits, and integer sums wrap around. MinMax of data with NaNs is unspecified.
+//
+// The kernels of BitVector and CompressedVector are in bit_vector_kernels.hpp and
+// compressed_vector_kernels.hpp, which reuse the namespaces and VECTOR_SIMD_DISPATCH below.
+
+enum class SimdLevel {
+    kScalar,
+    kSse2,
+    kAvx2,
+};
+
+inline SimdLevel BestSimdLevel() {
+#ifdef VECTOR_SIMD_X86
+    static const SimdLevel level = __builtin_cpu_supports("avx2") ? SimdLevel::kAvx2 : SimdLevel::kSse2;
+    return level;
+#else
+    return SimdLevel::kScalar;
+#endif
+}
+
+template <typename T>
+T WrappingAdd(T a, T b) {
+    if constexpr (std::is_integral_v<T>) {
+        using Unsigned = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<Unsigned>(a) + static_cast<Unsigned>(b));
+    } else {
+        return a + b;
+    }
+}
+
+// Number of set bits in a lane mask of up to 8 lanes. Without -mpopcnt
+// __builtin_popcount is a library call, slower than the comparison itself.
+inline size_t LaneCount(unsigned mask) {
+    static constexpr unsigned char kNibbleBits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+    return kNibbleBits[mask & 0xF] + kNibbleBits[(mask >> 4) & 0xF];
+}
+
+// Single-lane operations for any T: the fallback, and what the SIMD namespaces
+// use for types they have no registers for
+namespace simd_scalar {
+
+template <typename T>
+struct Ops {
+    static constexpr size_t kLanes = 1;
+    static constexpr unsigned kAllLanes = 1;
+
+    static T Load(const T* ptr) { return *ptr; }
+    static void Store(T* ptr, T reg) { *ptr = reg; }
+    static T Set1(T value) { return value; }
+    static T Add(T a, T b) { return WrappingAdd(a, b); }
+    static T Min(T a, T b) { return b < a ? b : a; }
+    static T Max(T a, T b) { return a < b ? b : a; }
+    static unsigned EqMask(T a, T b) { return a == b ? 1u : 0u; }
+};
+
+#include "simd_kernels.hpp"
+
+}  // namespace simd_scalar
+
+#ifdef VECTOR_SIMD_X86
+
+namespace simd_sse2 {
+
+template <typename T>
+struct Ops : simd_scalar::Ops<T> {};
+
+template <>
+struct Ops<int32_t> {
+    static constexpr size_t kLanes = 4;
+    static constexpr unsigned kAllLanes = 0xF;
+
+    static __m128i Load(const int32_t* ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+    static void Store(int32_t* ptr, __m128i reg) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), reg); }
+    static __m128i Set1(int32_t value) { return _mm_set1_epi32(value); }
+    static __m128i Add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+
+    // pminsd/pmaxsd are SSE4.1, here a comparison selects the lanes
+    static __m128i Min(__m128i a, __m128i b) {
+        __m128i less = _mm_cmplt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(less, a), _mm_andnot_si128(less, b));
+    }
+
+    static __m128i Max(__m128i a, __m128i b) {
+        __m128i greater = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+    }
+
+    static unsigned EqMask(__m128i a, __m128i b) {
+        return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))));
+    }
+};
+
+template <>
+struct Ops<float> {
+    static constexpr size_t kLanes = 4;
+    static constexpr unsigned kAllLanes = 0xF;
+
+    static __m128 Load(const float* ptr) { return _mm_loadu_ps(ptr); }
+    static void Store(float* ptr, __m128 reg) { _mm_storeu_ps(ptr, reg); }
+    static __m128 Set1(float value) { return _mm_set1_ps(value); }
+    static __m128 Add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+    static __m128 Min(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+    static __m128 Max(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+    static unsigned EqMask(__m128 a, __m128 b) { return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(a, b))); }
+};
+
+template <>
+struct Ops<double> {
+    static constexpr size_t kLanes = 2;
+    static constexpr unsigned kAllLanes = 0x3;
+
+    static __m128d Load(const double* ptr) { return _mm_loadu_pd(ptr); }
+    static void Store(double* ptr, __m128d reg) { _mm_storeu_pd(ptr, reg); }
+    static __m128d Set1(double value) { return _mm_set1_pd(value); }
+    static __m128d Add(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+    static __m128d Min(__m128d a, __m128d b) { return _mm_min_pd(a, b); }
+    static __m128d Max(__m128d a, __m128d b) { return _mm_max_pd(a, b); }
+    static unsigned EqMask(__m128d a, __m128d b) { return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(a, b))); }
+};
+
+#include "simd_kernels.hpp"
+
+}  // namespace simd_sse2
+
+// Everything up to the pop is compiled for AVX2 and only called after the CPU check
+#ifdef __clang__
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace simd_avx2 {
+
+template <typename T>
+struct Ops : simd_scalar::Ops<T> {};
+
+template <>
+struct Ops<int32_t> {
+    static constexpr size_t kLanes = 8;
+    static constexpr unsigned kAllLanes = 0xFF;
+
+    static __m256i Load(const int32_t* ptr) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)); }
+    static void Store(int32_t* ptr, __m256i reg) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), reg); }
+    static __m256i Set1(int32_t value) { return _mm256_set1_epi32(value); }
+    static __m256i Add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+    static __m256i Min(__m256i a, __m256i b) { return _mm256_min_epi32(a, b); }
+    static __m256i Max(__m256i a, __m256i b) { return _mm256_max_epi32(a, b); }
+
+    static unsigned EqMask(__m256i a, __m256i b) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b))));
+    }
+};
+
+template <>
+struct Ops<float> {
+    static constexpr size_t kLanes = 8;
+    static constexpr unsigned kAllLanes = 0xFF;
+
+    static __m256 Load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+    static void Store(float* ptr, __m256 reg) { _mm256_storeu_ps(ptr, reg); }
+    static __m256 Set1(float value) { return _mm256_set1_ps(value); }
+    static __m256 Add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+    static __m256 Min(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+    static __m256 Max(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+
+    static unsigned EqMask(__m256 a, __m256 b) {
+        return static_cast<unsigned>(_mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ)));
+    }
+};
+
+template <>
+struct Ops<double> {
+    static constexpr size_t kLanes = 4;
+    static constexpr unsigned kAllLanes = 0xF;
+
+    static __m256d Load(const double* ptr) { return _mm256_loadu_pd(ptr); }
+    static void Store(double* ptr, __m256d reg) { _mm256_storeu_pd(ptr, reg); }
+    static __m256d Set1(double value) { return _mm256_set1_pd(value); }
+    static __m256d Add(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+    static __m256d Min(__m256d a, __m256d b) { return _mm256_min_pd(a, b); }
+    static __m256d Max(__m256d a, __m256d b) { return _mm256_max_pd(a, b); }
+
+    static unsigned EqMask(__m256d a, __m256d b) {
+        return static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)));
+    }
+};
+
+#include "simd_kernels.hpp"
+
+}  // namespace simd_avx2
+
+#ifdef __clang__
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#else
+
+namespace simd_sse2 = simd_scalar;
+namespace simd_avx2 = simd_scalar;
+
+#endif
+
+// Calls the same kernel from the namespace of the best instruction set allowed by level.
+// Kept defined for the headers that add kernels of their own to those namespaces.
+#define VECTOR_SIMD_DISPATCH(level, kernel, ...)                             \
+    switch (std::min(level, BestSimdLevel())) {                              \
+        case SimdLevel::kAvx2:                                               \
+            return simd_avx2::kernel(__VA_ARGS__);                           \
+        case SimdLevel::kSse2:                                               \
+            return simd_sse2::kernel(__VA_ARGS__);                           \
+        default:                                                             \
+            return simd_scalar::kernel(__VA_ARGS__);                         \
+    }
+
+namespace simd {
+
+template <typename T>
+constexpr bool kIsSimdArithmetic = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
+template <typename T, typename Alloc, typename Growth>
+void Fill(Vector<T, Alloc, Growth>& v, const typename Vector<T, Alloc, Growth>::ValueType& value,
+          SimdLevel level = BestSimdLevel()) {
+    static_assert(kIsSimdArithmetic<T>, "SIMD algorithms are for arithmetic types");
+    VECTOR_SIMD_DISPATCH(level, Fill, v.Data(), v.Size(), value)
+}
+
+template <typename T, typename Alloc, typename Growth>
+typename Vector<T, Alloc, Growth>::ConstIterator Find(const Vector<T, Alloc, Growth>& v,
+                                                      const typename Vector<T, Alloc, Growth>::ValueType& value,
+                                                      SimdLevel level = BestSimdLevel()) {
+    static_assert(kIsSimdArithmetic<T>, "SIMD algorithms are for arithmetic types");
+    auto find = [&] { VECTOR_SIMD_DISPATCH(level, Find, v.Data(), v.Size(), value) };
+    return v.begin() + find();
+}
+
+template <typename T, typename Alloc, typename Growth>
+size_t Count(const Vector<T, Alloc, Growth>& v, const typename Vector<T, Alloc, Growth>::ValueType& value,
+             SimdLevel level = BestSimdLevel()) {
+    static_assert(kIsSimdArithmetic<T>, "SIMD algorithms are for arithmetic types");
+    VECTOR_SIMD_DISPATCH(level, Count, v.Data(), v.Size(), value)
+}
+
+template <typename T, typename Alloc, typename Growth>
+T Sum(const Vector<T, Alloc, Growth>& v, SimdLevel level = BestSimdLevel()) {
+    static_assert(kIsSimdArithmetic<T>, "SIMD algorithms are for arithmetic types");
+    VECTOR_SIMD_DISPATCH(level, Sum, v.Data(), v.Size())
+}
+
+// The vector must not be empty
+template <typename T, typename Alloc, typename Growth>
+std::pair<T, T> MinMax(const Vector<T, Alloc, Growth>& v, SimdLevel level = BestSimdLevel()) {
+    static_assert(kIsSimdArithmetic<T>, "SIMD algorithms are for arithmetic types");
+    VECTOR_SIMD_DISPATCH(level, MinMax, v.Data(), v.Size())
+}
+
+template <typename T>
+size_t Mismatch(const T* a, const T* b, size_t size, SimdLevel level) {
+    VECTOR_SIMD_DISPATCH(level, Mismatch, a, b, size)
+}
+
+template <typename T, typename Alloc1, typename Growth1, typename Alloc2, typename Growth2>
+bool Equal(const Vector<T, Alloc1, Growth1>& a, const Vector<T, Alloc2, Growth2>& b,
+           SimdLevel level = BestSimdLevel()) {
+    static_assert(kIsSimdArithmetic<T>, "SIMD algorithms are for arithmetic types");
+    return a.Size() == b.Size() && Mismatch(a.Data(), b.Data(), a.Size(), level) == a.Size();
+}
+
+// Same as std::lexicographical_compare: elements that are neither less nor greater,
+// like NaN against anything, count as equivalent
+template <typename T, typename Alloc1, typename Growth1, typename Alloc2, typename Growth2>
+bool LexicographicalCompare(const Vector<T, Alloc1, Growth1>& a, const Vector<T, Alloc2, Growth2>& b,
+                            SimdLevel level = BestSimdLevel()) {
+    static_assert(kIsSimdArithmetic<T>, "SIMD algorithms are for arithmetic types");
+    size_t size = std::min(a.Size(), b.Size());
+    size_t idx = 0;
+    while ((idx += Mismatch(a.Data() + idx, b.Data() + idx, size - idx, level)) < size) {
+        if (a[idx] < b[idx])
+            return true;
+        if (b[idx] < a[idx])
+            return false;
+        ++idx;
+    }
+    return a.Size() < b.Size();
+}
+
+}  // namespace simd
@@ -0,0 +1,115 @@
+// Algorithms over plain arrays, written once against Ops<T> of the namespace that
+// includes this file. simd_algorithms.hpp includes it once per instruction set,
+// so there is no include guard on purpose.
+
+template <typename T>
+void Fill(T* data, size_t size, T value) {
+    using O = Ops<T>;
+    const auto reg = O::Set1(value);
+    size_t i = 0;
+    for (; i + O::kLanes <= size; i += O::kLanes)
+        O::Store(data + i, reg);
+    for (; i < size; ++i)
+        data[i] = value;
+}
+
+template <typename T>
+size_t Find(const T* data, size_t size, T value) {
+    using O = Ops<T>;
+    const auto needle = O::Set1(value);
+    size_t i = 0;
+    for (; i + O::kLanes <= size; i += O::kLanes) {
+        unsigned mask = O::EqMask(O::Load(data + i), needle);
+        if (mask != 0)
+            return i + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    for (; i < size && !(data[i] == value); ++i) {}
+    return i;
+}
+
+template <typename T>
+size_t Count(const T* data, size_t size, T value) {
+    using O = Ops<T>;
+    const auto needle = O::Set1(value);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + O::kLanes <= size; i += O::kLanes)
+        count += LaneCount(O::EqMask(O::Load(data + i), needle));
+    for (; i < size; ++i)
+        count += data[i] == value;
+    return count;
+}
+
+// Four independent accumulators, so that the additions don't wait for each other
+template <typename T>
+T Sum(const T* data, size_t size) {
+    using O = Ops<T>;
+    auto acc0 = O::Set1(T());
+    auto acc1 = acc0;
+    auto acc2 = acc0;
+    auto acc3 = acc0;
+    size_t i = 0;
+    for (; i + 4 * O::kLanes <= size; i += 4 * O::kLanes) {
+        acc0 = O::Add(acc0, O::Load(data + i));
+        acc1 = O::Add(acc1, O::Load(data + i + O::kLanes));
+        acc2 = O::Add(acc2, O::Load(data + i + 2 * O::kLanes));
+        acc3 = O::Add(acc3, O::Load(data + i + 3 * O::kLanes));
+    }
+    for (; i + O::kLanes <= size; i += O::kLanes)
+        acc0 = O::Add(acc0, O::Load(data + i));
+    acc0 = O::Add(O::Add(acc0, acc1), O::Add(acc2, acc3));
+
+    T lanes[O::kLanes];
+    O::Store(lanes, acc0);
+    T sum = T();
+    for (size_t lane = 0; lane < O::kLanes; ++lane)
+        sum = WrappingAdd(sum, lanes[lane]);
+    for (; i < size; ++i)
+        sum = WrappingAdd(sum, data[i]);
+    return sum;
+}
+
+// size must be positive
+template <typename T>
+std::pair<T, T> MinMax(const T* data, size_t size) {
+    using O = Ops<T>;
+    T min = data[0];
+    T max = data[0];
+    size_t i = 0;
+    if (size >= O::kLanes) {
+        auto low = O::Load(data);
+        auto high = low;
+        for (i = O::kLanes; i + O::kLanes <= size; i += O::kLanes) {
+            const auto reg = O::Load(data + i);
+            low = O::Min(low, reg);
+            high = O::Max(high, reg);
+        }
+
+        T lanes[O::kLanes];
+        O::Store(lanes, low);
+        min = *std::min_element(lanes, lanes + O::kLanes);
+        O::Store(lanes, high);
+        max = *std::max_element(lanes, lanes + O::kLanes);
+    }
+    for (; i < size; ++i) {
+        if (data[i] < min)
+            min = data[i];
+        if (max < data[i])
+            max = data[i];
+    }
+    return {min, max};
+}
+
+// Index of the first i with !(a[i] == b[i]), or size
+template <typename T>
+size_t Mismatch(const T* a, const T* b, size_t size) {
+    using O = Ops<T>;
+    size_t i = 0;
+    for (; i + O::kLanes <= size; i += O::kLanes) {
+        unsigned mask = O::EqMask(O::Load(a + i), O::Load(b + i));
+        if (mask != O::kAllLanes)
+            return i + static_cast<size_t>(__builtin_ctz(~mask));
+    }
+    for (; i < size && a[i] == b[i]; ++i) {}
+    return i;
+}
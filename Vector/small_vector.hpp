@@ -0,0 +1,416 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include "vector.hpp"
+
+// Vector that keeps up to N elements inside the object itself and moves them
+// to the heap only when it grows beyond that.
+template <typename T, size_t N>
+class SmallVector {
+
+static_assert(N > 0, "SmallVector needs room for at least one inline element");
+
+public:
+
+using ValueType = T;
+using Pointer = T*;
+using ConstPointer = const T*;
+using Reference = T&;
+using ConstReference = const T&;
+using SizeType = size_t;
+using Iterator = T*;
+using ConstIterator = const T*;
+using ReverseIterator = std::reverse_iterator<Iterator>;
+using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+
+static constexpr size_t kInlineCapacity = N;
+
+
+//------------------------------constructors------------------------------
+
+    SmallVector() : data_(InlineData()), size_(0), capacity_(N) {}
+
+    SmallVector(size_t size) : SmallVector() {
+        Resize(size);
+    }
+
+    SmallVector(size_t size, const T& elem) : SmallVector() {
+        Resize(size, elem);
+    }
+
+    SmallVector(const std::initializer_list<T>& list) : SmallVector(list.begin(), list.end()) {}
+
+    SmallVector(const SmallVector& other) : SmallVector(other.begin(), other.end()) {}
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : SmallVector() {
+        MoveFrom(other);
+    }
+
+    template<typename InputIterator,
+    typename = typename std::iterator_traits<InputIterator>::iterator_category>
+    SmallVector(InputIterator begin, InputIterator end) : SmallVector() {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag,
+                      typename std::iterator_traits<InputIterator>::iterator_category>) {
+            Reserve(static_cast<size_t>(std::distance(begin, end)));
+        }
+        for (; begin != end; ++begin)
+            PushBack(*begin);
+    }
+
+//-----------------------------destructor--------------------------------
+
+    ~SmallVector() {
+        Destroy();
+    }
+
+//-----------------------------iterators--------------------------------
+
+    Iterator begin() {
+        return data_;
+    }
+
+    ConstIterator begin() const {
+        return data_;
+    }
+
+    Iterator end() {
+        return data_ + size_;
+    }
+
+    ConstIterator end() const {
+        return data_ + size_;
+    }
+
+    ConstIterator cbegin() const {
+        return data_;
+    }
+
+    ConstIterator cend() const {
+        return data_ + size_;
+    }
+
+    ReverseIterator rbegin() {
+        return std::reverse_iterator(end());
+    }
+
+    ConstReverseIterator rbegin() const {
+        return std::reverse_iterator(end());
+    }
+
+    ConstReverseIterator crbegin() const {
+        return rbegin();
+    }
+
+    ReverseIterator rend() {
+        return std::reverse_iterator(begin());
+    }
+
+    ConstReverseIterator rend() const {
+        return std::reverse_iterator(begin());
+    }
+
+    ConstReverseIterator crend() const {
+        return rend();
+    }
+
+//-----------------------------operators--------------------------------
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this == &other)
+            return *this;
+
+        SmallVector temp = other;
+        Swap(temp);
+
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        if (!other.IsInline()) {
+            Destroy();
+            data_ = InlineData();
+            capacity_ = N;
+        }
+        MoveFrom(other);
+
+        return *this;
+    }
+
+    T& operator[](size_t idx) {
+        return data_[idx];
+    }
+
+    const T& operator[](size_t idx) const {
+        return data_[idx];
+    }
+
+//-----------------------------methods----------------------------------
+
+    void Swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (!IsInline() && !other.IsInline()) {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+            return;
+        }
+
+        SmallVector temp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(temp);
+    }
+
+    T* Data() {
+        return data_;
+    }
+
+    const T* Data() const {
+        return data_;
+    }
+
+    T& Front() {
+        return data_[0];
+    }
+
+    const T& Front() const {
+        return data_[0];
+    }
+
+    T& Back() {
+        return data_[size_ - 1];
+    }
+
+    const T& Back() const {
+        return data_[size_ - 1];
+    }
+
+    T& At(size_t idx) {
+        if (idx >= size_)
+            throw std::out_of_range("Out of range");
+        return data_[idx];
+    }
+
+    const T& At(size_t idx) const {
+        if (idx >= size_)
+            throw std::out_of_range("Out of range");
+        return data_[idx];
+    }
+
+    size_t Size() const {
+        return size_;
+    }
+
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+    bool Empty() const {
+        return size_ == 0;
+    }
+
+    bool IsInline() const {
+        return data_ == InlineData();
+    }
+
+    void Clear() {
+        DestroyRange(data_, data_ + size_);
+        size_ = 0;
+    }
+
+    void Resize(size_t size) {
+        if (size <= size_) {
+            DestroyRange(data_ + size, data_ + size_);
+            size_ = size;
+            return;
+        }
+
+        Append(size - size_, size, [](T* place) { new (place) T(); });
+    }
+
+    void Resize(size_t size, const T& elem) {
+        if (size <= size_) {
+            DestroyRange(data_ + size, data_ + size_);
+            size_ = size;
+            return;
+        }
+
+        Append(size - size_, size, [&elem](T* place) { new (place) T(elem); });
+    }
+
+    void Reserve(size_t capacity) {
+        if (capacity_ >= capacity)
+            return;
+
+        Append(0, capacity, [](T*) {}, true);
+    }
+
+    void ShrinkToFit() {
+        if (IsInline() || capacity_ == size_)
+            return;
+
+        if (size_ <= N) {
+            T* heap_data = data_;
+            size_t heap_capacity = capacity_;
+            Relocate(heap_data, InlineData(), size_);
+            data_ = InlineData();
+            capacity_ = N;
+            Deallocate(heap_data, heap_capacity);
+            return;
+        }
+
+        Append(0, size_, [](T*) {}, true);
+    }
+
+    template<typename... Args>
+    void EmplaceBack(Args&&... args) {
+        Append(1, std::max(static_cast<size_t>(1), capacity_ * 2),
+               [&args...](T* place) { new (place) T(std::forward<Args>(args)...); });
+    }
+
+    void PushBack(const T& elem) {
+        EmplaceBack(elem);
+    }
+
+    void PushBack(T&& elem) {
+        EmplaceBack(std::move(elem));
+    }
+
+    void PopBack() {
+        if (size_ > 0) {
+            (data_ + size_ - 1)->~T();
+            size_--;
+        }
+    }
+
+private:
+    T* InlineData() {
+        return reinterpret_cast<T*>(inline_);
+    }
+
+    const T* InlineData() const {
+        return reinterpret_cast<const T*>(inline_);
+    }
+
+    static T* Allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    static void Deallocate(T* data, size_t count) {
+        ::operator delete(data, count * sizeof(T), std::align_val_t(alignof(T)));
+    }
+
+    static void DestroyRange(T* begin, T* end) {
+        for (; begin != end; ++begin)
+            begin->~T();
+    }
+
+    // Moves count elements to uninitialized memory and destroys the originals.
+    // If a throwing copy fails, the source is left untouched.
+    static void Relocate(T* from, T* to, size_t count) {
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            if (count > 0)
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+        } else {
+            size_t idx = 0;
+            try {
+                for (idx = 0; idx < count; ++idx)
+                    new (to + idx) T(std::move_if_noexcept(from[idx]));
+            }
+            catch (...) {
+                DestroyRange(to, to + idx);
+                throw;
+            }
+            DestroyRange(from, from + count);
+        }
+    }
+
+    // Constructs count new elements at the end. When they don't fit, the new elements
+    // are built directly in a buffer of new_capacity first and only then the old ones
+    // are moved over, so a failure at any step leaves the vector as it was.
+    template <typename Construct>
+    void Append(size_t count, size_t new_capacity, Construct&& construct, bool force_reallocation = false) {
+        size_t new_size = size_ + count;
+        if (new_size <= capacity_ && !force_reallocation) {
+            size_t idx = size_;
+            try {
+                for (; idx < new_size; ++idx)
+                    construct(data_ + idx);
+            }
+            catch (...) {
+                DestroyRange(data_ + size_, data_ + idx);
+                throw;
+            }
+            size_ = new_size;
+            return;
+        }
+
+        new_capacity = std::max(new_capacity, new_size);
+        T* new_data = Allocate(new_capacity);
+        size_t idx = size_;
+        try {
+            for (; idx < new_size; ++idx)
+                construct(new_data + idx);
+            Relocate(data_, new_data, size_);
+        }
+        catch (...) {
+            DestroyRange(new_data + size_, new_data + idx);
+            Deallocate(new_data, new_capacity);
+            throw;
+        }
+
+        if (!IsInline())
+            Deallocate(data_, capacity_);
+        data_ = new_data;
+        size_ = new_size;
+        capacity_ = new_capacity;
+    }
+
+    // Takes the elements of other, which is left empty. If moving an inline element
+    // throws, this stays empty and other keeps its elements, some of them moved from.
+    void MoveFrom(SmallVector& other) {
+        // More than N elements are always on the heap. Saying so bounds the inline
+        // loop below for the compiler, which can't tell that from data_.
+        if (other.size_ > N || !other.IsInline()) {
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+        } else {
+            size_t idx = 0;
+            try {
+                for (; idx < other.size_; ++idx)
+                    new (data_ + idx) T(std::move(other.data_[idx]));
+            }
+            catch (...) {
+                DestroyRange(data_, data_ + idx);
+                throw;
+            }
+            size_ = other.size_;
+            DestroyRange(other.data_, other.data_ + other.size_);
+        }
+
+        other.data_ = other.InlineData();
+        other.size_ = 0;
+        other.capacity_ = N;
+    }
+
+    void Destroy() {
+        DestroyRange(data_, data_ + size_);
+        if (!IsInline())
+            Deallocate(data_, capacity_);
+    }
+
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+};
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "vector.hpp"
+#include "../Tuple/tuple.hpp"
+
+template <typename Row>
+class SoAVector;
+
+// Vector of rows Tuple<Ts...> stored as one Vector per column ("struct of arrays"),
+// so that a loop over one field reads only that field's memory instead of whole rows.
+//
+// Rows are reached through proxies: v[i] is a Tuple<Ts&...> of references into the
+// columns, get<1>(v[i]) = x writes a single field. Whole columns are exposed as spans
+// by Column<I>(). Every operation that adds rows does so in all columns, and if one
+// column fails, the columns already changed are brought back to the old size.
+template <typename... Ts>
+class SoAVector<Tuple<Ts...>> {
+
+static_assert(sizeof...(Ts) > 0, "SoAVector needs at least one column");
+
+public:
+
+using RowType = Tuple<Ts...>;
+using Reference = Tuple<Ts&...>;
+using ConstReference = Tuple<const Ts&...>;
+using SizeType = size_t;
+
+template <size_t I>
+using ColumnType = tuple_element_t<I, RowType>;
+
+static constexpr size_t kColumns = sizeof...(Ts);
+
+
+//------------------------------constructors------------------------------
+
+    SoAVector() = default;
+
+    explicit SoAVector(size_t size) {
+        Resize(size);
+    }
+
+    SoAVector(size_t size, const RowType& row) {
+        Resize(size, row);
+    }
+
+//-----------------------------operators--------------------------------
+
+    Reference operator[](size_t idx) {
+        return RowAt(idx, std::index_sequence_for<Ts...>());
+    }
+
+    ConstReference operator[](size_t idx) const {
+        return RowAt(idx, std::index_sequence_for<Ts...>());
+    }
+
+//-----------------------------methods----------------------------------
+
+    Reference At(size_t idx) {
+        if (idx >= Size())
+            throw std::out_of_range("Out of range");
+        return (*this)[idx];
+    }
+
+    ConstReference At(size_t idx) const {
+        if (idx >= Size())
+            throw std::out_of_range("Out of range");
+        return (*this)[idx];
+    }
+
+    // A copy of the row, as opposed to the references operator[] gives
+    RowType GetRow(size_t idx) const {
+        return CopyRow(idx, std::index_sequence_for<Ts...>());
+    }
+
+    template <size_t I>
+    std::span<ColumnType<I>> Column() {
+        auto& column = get<I>(columns_);
+        return std::span<ColumnType<I>>(column.Data(), column.Size());
+    }
+
+    template <size_t I>
+    std::span<const ColumnType<I>> Column() const {
+        const auto& column = get<I>(columns_);
+        return std::span<const ColumnType<I>>(column.Data(), column.Size());
+    }
+
+    size_t Size() const {
+        return get<0>(columns_).Size();
+    }
+
+    // Rows that fit before some column has to reallocate
+    size_t Capacity() const {
+        return MinCapacity(std::index_sequence_for<Ts...>());
+    }
+
+    bool Empty() const {
+        return Size() == 0;
+    }
+
+    void Clear() {
+        ForEachColumn([](auto& column, auto) { column.Clear(); });
+    }
+
+    void Reserve(size_t capacity) {
+        ForEachColumn([capacity](auto& column, auto) { column.Reserve(capacity); });
+    }
+
+    void ShrinkToFit() {
+        ForEachColumn([](auto& column, auto) { column.ShrinkToFit(); });
+    }
+
+    void Resize(size_t size) {
+        if (size <= Size()) {
+            Truncate(size);
+            return;
+        }
+
+        GrowColumns([size](auto& column, auto) { column.Resize(size); });
+    }
+
+    void Resize(size_t size, const RowType& row) {
+        if (size <= Size()) {
+            Truncate(size);
+            return;
+        }
+
+        GrowColumns([size, &row](auto& column, auto column_idx) {
+            column.Resize(size, get<decltype(column_idx)::value>(row));
+        });
+    }
+
+    void PushBack(const RowType& row) {
+        GrowColumns([&row](auto& column, auto column_idx) {
+            column.PushBack(get<decltype(column_idx)::value>(row));
+        });
+    }
+
+    void PushBack(RowType&& row) {
+        GrowColumns([&row](auto& column, auto column_idx) {
+            column.PushBack(std::move(get<decltype(column_idx)::value>(row)));
+        });
+    }
+
+    // One argument per column, each column builds its element from its own argument
+    template <typename... Args>
+    void EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == kColumns, "EmplaceBack takes one argument per column");
+
+        auto forwarded = std::forward_as_tuple(std::forward<Args>(args)...);
+        GrowColumns([&forwarded](auto& column, auto column_idx) {
+            constexpr size_t kIdx = decltype(column_idx)::value;
+            column.EmplaceBack(std::forward<std::tuple_element_t<kIdx, std::tuple<Args...>>>(std::get<kIdx>(forwarded)));
+        });
+    }
+
+    void PopBack() {
+        ForEachColumn([](auto& column, auto) { column.PopBack(); });
+    }
+
+    void Swap(SoAVector& other) noexcept {
+        ForEachColumn([&other](auto& column, auto column_idx) {
+            column.Swap(get<decltype(column_idx)::value>(other.columns_));
+        });
+    }
+
+private:
+    template <size_t... Is>
+    Reference RowAt(size_t idx, std::index_sequence<Is...>) {
+        return Reference(get<Is>(columns_)[idx]...);
+    }
+
+    template <size_t... Is>
+    ConstReference RowAt(size_t idx, std::index_sequence<Is...>) const {
+        return ConstReference(get<Is>(columns_)[idx]...);
+    }
+
+    template <size_t... Is>
+    RowType CopyRow(size_t idx, std::index_sequence<Is...>) const {
+        return RowType(get<Is>(columns_)[idx]...);
+    }
+
+    template <size_t... Is>
+    size_t MinCapacity(std::index_sequence<Is...>) const {
+        return std::min({get<Is>(columns_).Capacity()...});
+    }
+
+    // Calls func(column, std::integral_constant<size_t, I>()) for every column
+    template <typename Func, size_t I = 0>
+    void ForEachColumn(Func&& func) {
+        if constexpr (I < kColumns) {
+            func(get<I>(columns_), std::integral_constant<size_t, I>());
+            ForEachColumn<Func, I + 1>(std::forward<Func>(func));
+        }
+    }
+
+    // Like ForEachColumn, but if some column throws, the columns before it
+    // are cut back to the size they had, so all columns stay the same length
+    template <typename Grow>
+    void GrowColumns(Grow&& grow) {
+        GrowColumnsFrom<0>(Size(), grow);
+    }
+
+    template <size_t I, typename Grow>
+    void GrowColumnsFrom(size_t old_size, Grow& grow) {
+        if constexpr (I < kColumns) {
+            auto& column = get<I>(columns_);
+            grow(column, std::integral_constant<size_t, I>());
+            try {
+                GrowColumnsFrom<I + 1>(old_size, grow);
+            } catch (...) {
+                while (column.Size() > old_size)
+                    column.PopBack();
+                throw;
+            }
+        }
+    }
+
+    void Truncate(size_t size) {
+        ForEachColumn([size](auto& column, auto) {
+            while (column.Size() > size)
+                column.PopBack();
+        });
+    }
+
+    Tuple<Vector<Ts>...> columns_;
+};
@@ -0,0 +1,104 @@
+#define CATCH_CONFIG_MAIN
+#include <catch.hpp>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <memory>
+
+#include "test_util.hpp"
+#include "small_vector.hpp"
+
+TEST_CASE("Inline storage", "[SmallVector]") {
+  SmallVector<std::string, 4> v;
+  REQUIRE(v.Capacity() == 4u);
+  REQUIRE(v.IsInline());
+  REQUIRE(static_cast<const void*>(v.Data()) >= static_cast<const void*>(&v));
+  REQUIRE(static_cast<const void*>(v.Data()) < static_cast<const void*>(&v + 1));
+
+  for (int i = 0; i < 4; ++i) {
+    v.PushBack(std::to_string(i));
+    REQUIRE(v.IsInline());
+  }
+
+  v.EmplaceBack(3, 'x');
+  REQUIRE_FALSE(v.IsInline());
+  REQUIRE(v.Size() == 5u);
+  REQUIRE(v.Back() == "xxx");
+  REQUIRE(v.Front() == "0");
+
+  v.PopBack();
+  v.PopBack();
+  v.ShrinkToFit();
+  REQUIRE(v.IsInline());
+  REQUIRE(v.Capacity() == 4u);
+  REQUIRE(v[2] == "2");
+}
+
+TEST_CASE("Inline and heap mixes", "[SmallVector]") {
+  SmallVector<std::string, 2> small{"a", "b"};
+  SmallVector<std::string, 2> large{"c", "d", "e", "f"};
+  REQUIRE(small.IsInline());
+  REQUIRE_FALSE(large.IsInline());
+
+  small.Swap(large);
+  REQUIRE(small.Size() == 4u);
+  REQUIRE(small[3] == "f");
+  REQUIRE(large.Size() == 2u);
+  REQUIRE(large[1] == "b");
+  REQUIRE(large.IsInline());
+
+  auto copy = small;
+  large = std::move(small);
+  REQUIRE(small.Empty());
+  REQUIRE(small.IsInline());
+  REQUIRE(large[0] == "c");
+
+  copy = large;
+  REQUIRE(copy.Size() == 4u);
+
+  SmallVector<std::string, 2> moved(std::move(copy));
+  REQUIRE(moved.Size() == 4u);
+  REQUIRE(copy.Empty());
+}
+
+TEST_CASE("PushBack of own element", "[SmallVector]") {
+  SmallVector<std::vector<int>, 1> v;
+  v.PushBack({1, 2, 3});
+  for (int i = 0; i < 10; ++i) {
+    v.PushBack(v.Front());
+    v.EmplaceBack(v.Back());
+  }
+  REQUIRE(v.Size() == 21u);
+  for (const auto& elem : v) {
+    REQUIRE(elem == std::vector<int>{1, 2, 3});
+  }
+}
+
+// Owns memory, so a leaked element shows up under ASan, and throws from its
+// move constructor once until_throw runs out
+struct ThrowingMove {
+  static inline int until_throw = 0;
+  std::unique_ptr<int> p = std::make_unique<int>();
+
+  ThrowingMove() = default;
+
+  ThrowingMove(ThrowingMove&& other) : p(std::make_unique<int>(*other.p)) {
+    if (--until_throw <= 0) {
+      throw Exception{};
+    }
+  }
+};
+
+TEST_CASE("Throwing move of inline elements", "[SmallVector]") {
+  using Small = SmallVector<ThrowingMove, 4>;
+  Small v(3u);
+  ThrowingMove::until_throw = 2;
+  REQUIRE_THROWS_AS(Small(std::move(v)), Exception);
+  REQUIRE(v.Size() == 3u);
+
+  Small other(1u);
+  ThrowingMove::until_throw = 3;
+  REQUIRE_THROWS_AS(other = std::move(v), Exception);
+  REQUIRE(other.Empty());
+  REQUIRE(v.Size() == 3u);
+}
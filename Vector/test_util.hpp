@@ -4,6 +4,18 @@
 #include <catch.hpp>
 #include <stdexcept>
 
+// The container the memory and safety suites run against: Vector in test_vector,
+// SmallVector<T, 2> in test_small_vector, which builds them with TEST_SMALL_VECTOR
+#ifdef TEST_SMALL_VECTOR
+#include "small_vector.hpp"
+
+template <class T>
+using TestVector = SmallVector<T, 2>;
+#else
+template <class T>
+using TestVector = Vector<T>;
+#endif
+
 template <class T>
 void Equal(const Vector<T>& real, const std::vector<T>& required) {
   REQUIRE(real.Size() == required.size());
@@ -0,0 +1,64 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <string>
+
+#include "test_util.hpp"
+#include "aligned_allocator.hpp"
+
+template <typename T>
+bool IsAligned(const T* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+struct alignas(128) Slot {
+  int64_t counter = 0;
+};
+
+TEST_CASE("Over-aligned elements", "[Aligned]") {
+  Vector<Slot> v;
+  for (int i = 0; i < 100; ++i) {
+    v.PushBack(Slot{i});
+    REQUIRE(IsAligned(v.Data(), 128));
+  }
+  v.Insert(v.begin() + 3, Slot{-1});
+  v.ShrinkToFit();
+  REQUIRE(IsAligned(v.Data(), 128));
+  REQUIRE(v[3].counter == -1);
+  REQUIRE(v[100].counter == 99);
+}
+
+TEST_CASE("AlignedVector", "[Aligned]") {
+  AlignedVector<float> v;
+  for (int i = 0; i < 1000; ++i) {
+    v.PushBack(static_cast<float>(i));
+    REQUIRE(IsAligned(v.Data(), 64));
+  }
+
+  const auto copy = v;
+  REQUIRE(IsAligned(copy.Data(), 64));
+  REQUIRE(copy[999] == 999.0f);
+
+  AlignedVector<std::string, 4096> pages(3, "page");
+  REQUIRE(IsAligned(pages.Data(), 4096));
+  pages.Resize(1000, "more");
+  REQUIRE(IsAligned(pages.Data(), 4096));
+  REQUIRE(pages[2] == "page");
+
+  // The alignment of T wins when it is stricter
+  REQUIRE(AlignedAllocator<Slot, 16>::kAlignment == 128u);
+}
+
+TEST_CASE("Huge page allocation", "[Aligned]") {
+  using Allocator = AlignedAllocator<int64_t, 64, true>;
+  Vector<int64_t, Allocator> v;
+  v.Reserve(100);
+  REQUIRE(IsAligned(v.Data(), 64));
+  v.Reserve(1 << 20);
+  REQUIRE(IsAligned(v.Data(), Allocator::kHugePageSize));
+  v.Resize(1 << 20, 5);
+  REQUIRE(v[(1 << 20) - 1] == 5);
+  v.Resize(10);
+  v.ShrinkToFit();
+  REQUIRE(IsAligned(v.Data(), 64));
+  REQUIRE(v[9] == 5);
+}
@@ -0,0 +1,153 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "bit_vector.hpp"
+
+// The same random bits as a BitVector and as a std::vector<bool>
+static void RandomBits(size_t size, uint32_t seed, BitVector& bits, std::vector<bool>& expected) {
+  std::mt19937 gen(seed);
+  bits = BitVector(size);
+  expected.assign(size, false);
+  for (size_t i = 0; i < size; ++i) {
+    if (gen() % 3 == 0) {
+      bits.Set(i);
+      expected[i] = true;
+    }
+  }
+}
+
+TEST_CASE("BitVector bits", "[Bits]") {
+  BitVector bits;
+  REQUIRE(bits.Empty());
+  REQUIRE(bits.FindFirst() == BitVector::kNpos);
+
+  for (int i = 0; i < 200; ++i) {
+    bits.PushBack(i % 3 == 0);
+  }
+  REQUIRE(bits.Size() == 200u);
+  REQUIRE(bits.WordCount() == 4u);
+  REQUIRE(bits[0]);
+  REQUIRE(!bits[1]);
+  REQUIRE(bits.At(198));
+  REQUIRE_THROWS_AS(bits.At(200), std::out_of_range);
+
+  bits[1] = true;
+  bits[0] = bits[2];
+  bits.Flip(199);
+  REQUIRE(bits[1]);
+  REQUIRE(!bits[0]);
+  REQUIRE(bits[199]);
+  bits.Reset(199);
+  REQUIRE(bits.Count() == 67u);
+
+  bits.PopBack();
+  REQUIRE(bits.Count() == 67u);
+  bits.PopBack();
+  REQUIRE(bits.Size() == 198u);
+  REQUIRE(bits.Count() == 66u);
+
+  bits.SetAll();
+  REQUIRE(bits.All());
+  REQUIRE(bits.Count() == 198u);
+  // Bits past the size stay zero
+  REQUIRE(bits.Words()[3] == (uint64_t(1) << (198 - 192)) - 1);
+  bits.ResetAll();
+  REQUIRE(bits.None());
+}
+
+TEST_CASE("BitVector Resize", "[Bits]") {
+  BitVector bits(70, true);
+  REQUIRE(bits.Count() == 70u);
+  bits.Resize(100);
+  REQUIRE(bits.Count() == 70u);
+  REQUIRE(!bits[99]);
+  bits.Resize(130, true);
+  REQUIRE(bits.Count() == 100u);
+  REQUIRE(bits[129]);
+  REQUIRE(!bits[70]);
+  bits.Resize(65);
+  REQUIRE(bits.Count() == 65u);
+  REQUIRE(bits.WordCount() == 2u);
+  bits.Resize(128);
+  REQUIRE(bits.Count() == 65u);
+  REQUIRE(bits.Rank(128) == 65u);
+}
+
+TEST_CASE("BitVector Count, Rank and FindNext", "[Bits]") {
+  BitVector bits;
+  std::vector<bool> expected;
+  RandomBits(10007, 1, bits, expected);
+
+  size_t count = 0;
+  for (size_t i = 0; i <= expected.size(); ++i) {
+    REQUIRE(bits.Rank(i) == count);
+    if (i < expected.size() && expected[i]) {
+      ++count;
+    }
+  }
+  REQUIRE(bits.Count() == count);
+  for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2}) {
+    REQUIRE(PopCountWords(bits.Words(), bits.WordCount(), level) == count);
+  }
+
+  std::vector<size_t> found;
+  for (size_t idx = bits.FindFirst(); idx != BitVector::kNpos; idx = bits.FindNext(idx)) {
+    found.push_back(idx);
+  }
+  std::vector<size_t> visited;
+  bits.ForEachSet([&visited](size_t idx) { visited.push_back(idx); });
+  REQUIRE(found == visited);
+  REQUIRE(found.size() == count);
+  for (size_t idx : found) {
+    REQUIRE(expected[idx]);
+  }
+
+  BitVector sparse(1000);
+  sparse.Set(999);
+  REQUIRE(sparse.FindFirst() == 999u);
+  REQUIRE(sparse.FindNext(999) == BitVector::kNpos);
+}
+
+TEST_CASE("BitVector bitwise operations", "[Bits]") {
+  for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2}) {
+    BitVector a;
+    BitVector b;
+    std::vector<bool> expected_a;
+    std::vector<bool> expected_b;
+    RandomBits(1000, 2, a, expected_a);
+    RandomBits(1000, 3, b, expected_b);
+
+    BitVector and_bits = a;
+    CombineWords<BitOp::kAnd>(and_bits.Words(), b.Words(), a.WordCount(), level);
+    BitVector and_not = a;
+    CombineWords<BitOp::kAndNot>(and_not.Words(), b.Words(), a.WordCount(), level);
+    for (size_t i = 0; i < 1000; ++i) {
+      REQUIRE(and_bits[i] == (expected_a[i] && expected_b[i]));
+      REQUIRE(and_not[i] == (expected_a[i] && !expected_b[i]));
+    }
+  }
+
+  BitVector a;
+  BitVector b;
+  std::vector<bool> expected_a;
+  std::vector<bool> expected_b;
+  RandomBits(777, 4, a, expected_a);
+  RandomBits(777, 5, b, expected_b);
+  BitVector or_bits = a | b;
+  BitVector xor_bits = a ^ b;
+  BitVector and_bits = a & b;
+  BitVector and_not = a;
+  and_not.AndNot(b);
+  for (size_t i = 0; i < 777; ++i) {
+    REQUIRE(or_bits[i] == (expected_a[i] || expected_b[i]));
+    REQUIRE(xor_bits[i] == (expected_a[i] != expected_b[i]));
+    REQUIRE(and_bits[i] == (expected_a[i] && expected_b[i]));
+    REQUIRE(and_not[i] == (expected_a[i] && !expected_b[i]));
+  }
+  REQUIRE((a ^ a).None());
+  REQUIRE(((a & b) | (a ^ b)) == (a | b));
+  REQUIRE_THROWS_AS(a &= BitVector(10), std::invalid_argument);
+}
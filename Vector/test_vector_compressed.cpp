@@ -0,0 +1,89 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "compressed_vector.hpp"
+
+// Mostly increasing ids of about 25 bits, with a few steps back
+static std::vector<uint64_t> MostlySorted(size_t count, uint32_t seed) {
+  std::mt19937_64 gen(seed);
+  std::vector<uint64_t> values;
+  uint64_t current = 1 << 20;
+  for (size_t i = 0; i < count; ++i) {
+    current += gen() % 16;
+    values.push_back(gen() % 50 == 0 ? current - gen() % 1000 : current);
+  }
+  return values;
+}
+
+template <typename Compressed>
+static void RequireSame(const Compressed& compressed, const std::vector<uint64_t>& values) {
+  REQUIRE(compressed.Size() == values.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    REQUIRE(compressed[i] == values[i]);
+  }
+
+  for (SimdLevel level : {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2}) {
+    std::vector<uint64_t> decoded;
+    compressed.ForEachBlock([&decoded](const uint64_t* block, size_t count) {
+      decoded.insert(decoded.end(), block, block + count);
+    }, level);
+    REQUIRE(decoded == values);
+  }
+
+  Vector<uint64_t> all = compressed.Decompress();
+  REQUIRE(all.Size() == values.size());
+  REQUIRE(std::equal(all.begin(), all.end(), values.begin()));
+}
+
+TEMPLATE_TEST_CASE("Compressed round trip", "[Compressed]", BitPackCodec, FrameOfReferenceCodec, DeltaVarintCodec) {
+  CompressedVector<TestType> empty;
+  REQUIRE(empty.Empty());
+  REQUIRE(empty.BlockCount() == 0u);
+
+  std::vector<uint64_t> values = MostlySorted(10000, 1);
+  CompressedVector<TestType> compressed(values.begin(), values.end());
+  REQUIRE(compressed.BlockCount() == 40u);
+  RequireSame(compressed, values);
+  REQUIRE(compressed.MemoryBytes() < values.size() * sizeof(uint64_t) / 2);
+  REQUIRE_THROWS_AS(compressed.At(10000), std::out_of_range);
+
+  // Every bit width, including 0 and 64
+  std::mt19937_64 gen(2);
+  std::vector<uint64_t> widths;
+  for (unsigned width = 0; width <= 64; ++width) {
+    for (size_t i = 0; i < kPackedBlockSize; ++i) {
+      uint64_t value = width == 0 ? 0 : gen() >> (64 - width);
+      widths.push_back(i == 7 && width > 0 ? uint64_t(-1) >> (64 - width) : value);
+    }
+  }
+  widths.push_back(std::numeric_limits<uint64_t>::max());
+  widths.push_back(0);
+  CompressedVector<TestType> wide;
+  wide.AppendRange(widths.begin(), widths.end());
+  RequireSame(wide, widths);
+
+  wide.Clear();
+  REQUIRE(wide.Empty());
+  wide.PushBack(5);
+  REQUIRE(wide[0] == 5u);
+}
+
+TEST_CASE("Compressed sizes", "[Compressed]") {
+  std::vector<uint64_t> values = MostlySorted(1 << 16, 3);
+  PackedVector packed(values.begin(), values.end());
+  FrameOfReferenceVector frames(values.begin(), values.end());
+  DeltaVector deltas(values.begin(), values.end());
+
+  // 25-bit values, but the blocks of frames span only about 12 bits
+  REQUIRE(packed.MemoryBytes() * 8 < values.size() * 26);
+  REQUIRE(frames.MemoryBytes() * 8 < values.size() * 14);
+  REQUIRE(deltas.MemoryBytes() * 8 < values.size() * 10);
+
+  uint64_t block[PackedVector::kBlockSize];
+  REQUIRE(frames.DecodeBlock(3, block) == PackedVector::kBlockSize);
+  REQUIRE(block[0] == values[3 * PackedVector::kBlockSize]);
+}
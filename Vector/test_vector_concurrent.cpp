@@ -0,0 +1,131 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector.hpp"
+
+TEST_CASE("Concurrent PushBack", "[Concurrent]") {
+  const int kThreads = 4;
+  const int kPerThread = 20000;
+  ConcurrentVector<int64_t> v;
+  std::vector<std::vector<size_t>> indices(kThreads);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&v, &indices, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        indices[t].push_back(v.PushBack(t * kPerThread + i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(v.Size() == kThreads * kPerThread);
+  std::vector<bool> seen(kThreads * kPerThread);
+  for (int t = 0; t < kThreads; ++t) {
+    for (int i = 0; i < kPerThread; ++i) {
+      REQUIRE(v[indices[t][i]] == t * kPerThread + i);
+      seen[static_cast<size_t>(v[indices[t][i]])] = true;
+    }
+    // Each thread gets increasing indices
+    REQUIRE(std::is_sorted(indices[t].begin(), indices[t].end()));
+  }
+  REQUIRE(std::count(seen.begin(), seen.end(), true) == kThreads * kPerThread);
+}
+
+TEST_CASE("Concurrent reads of stable elements", "[Concurrent]") {
+  ConcurrentVector<std::string> v;
+  v.PushBack("first");
+  const std::string& first = v[0];
+  const std::string* address = &first;
+
+  std::atomic<size_t> published{0};
+  std::thread writer([&v, &published] {
+    for (int i = 1; i < 50000; ++i) {
+      published.store(v.PushBack(std::to_string(i)) + 1, std::memory_order_release);
+    }
+  });
+
+  size_t checked = 1;
+  while (checked < 50000) {
+    size_t ready = published.load(std::memory_order_acquire);
+    for (; checked < ready; ++checked) {
+      REQUIRE(v[checked] == std::to_string(checked));
+    }
+  }
+  writer.join();
+
+  REQUIRE(&v[0] == address);
+  REQUIRE(first == "first");
+  REQUIRE(v.At(49999) == "49999");
+  REQUIRE_THROWS_AS(v.At(50000), std::out_of_range);
+}
+
+TEST_CASE("Concurrent GrowBy and Reserve", "[Concurrent]") {
+  ConcurrentVector<std::unique_ptr<int>> pointers;
+  pointers.Reserve(1000);
+  REQUIRE(pointers.Empty());
+  REQUIRE(pointers.EmplaceBack(std::make_unique<int>(5)) == 0u);
+  REQUIRE(*pointers[0] == 5);
+
+  ConcurrentVector<int> v;
+  std::vector<std::thread> threads;
+  std::vector<size_t> firsts(8);
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&v, &firsts, t] {
+      firsts[t] = v.GrowBy(100, t);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(v.Size() == 800u);
+  for (int t = 0; t < 8; ++t) {
+    for (size_t i = firsts[t]; i < firsts[t] + 100; ++i) {
+      REQUIRE(v[i] == t);
+    }
+  }
+}
+
+// InstanceCounter may throw on moves, ConcurrentVector needs them noexcept
+struct NothrowCounter {
+  static std::atomic<int> alive;
+
+  NothrowCounter() noexcept {
+    ++alive;
+  }
+
+  NothrowCounter(const NothrowCounter&) noexcept : NothrowCounter() {
+  }
+
+  NothrowCounter(NothrowCounter&&) noexcept : NothrowCounter() {
+  }
+
+  ~NothrowCounter() {
+    --alive;
+  }
+};
+
+std::atomic<int> NothrowCounter::alive{0};
+
+TEST_CASE("Concurrent [Memory]") {
+  {
+    ConcurrentVector<NothrowCounter> v;
+    for (int i = 0; i < 1000; ++i) {
+      v.EmplaceBack();
+    }
+    REQUIRE(NothrowCounter::alive == 1000);
+    v.Clear();
+    REQUIRE(NothrowCounter::alive == 0);
+    v.GrowBy(10);
+    REQUIRE(NothrowCounter::alive == 10);
+  }
+  REQUIRE(NothrowCounter::alive == 0);
+}
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+#include <memory>
+#include <vector>
+
+#include "test_util.hpp"
+#include "vector.hpp"
+
+// User-supplied policy: grows by a fixed number of elements
+struct AddSixteenGrowth {
+  static size_t NextCapacity(size_t capacity, size_t required, size_t) {
+    return std::max(required, capacity + 16);
+  }
+};
+
+template <typename Vec>
+std::vector<size_t> Capacities(size_t count) {
+  Vec v;
+  std::vector<size_t> capacities;
+  for (size_t i = 0; i < count; ++i) {
+    v.PushBack(static_cast<int>(i));
+    if (capacities.empty() || capacities.back() != v.Capacity()) {
+      capacities.push_back(v.Capacity());
+    }
+  }
+  return capacities;
+}
+
+TEST_CASE("Growth policies", "[Growth]") {
+  using Alloc = std::allocator<int>;
+
+  REQUIRE(Capacities<Vector<int>>(100) == std::vector<size_t>{1, 2, 4, 8, 16, 32, 64, 128});
+  REQUIRE(Capacities<Vector<int, Alloc, OneAndHalfGrowth>>(30) == std::vector<size_t>{1, 2, 3, 4, 6, 9, 13, 19, 28, 42});
+  REQUIRE(Capacities<Vector<int, Alloc, AddSixteenGrowth>>(50) == std::vector<size_t>{16, 32, 48, 64});
+  REQUIRE(Capacities<Vector<int, Alloc, PageRoundedGrowth<>>>(3000) == std::vector<size_t>{1024, 2048, 4096});
+
+  REQUIRE(SizeClassGrowth<>::SizeClass(1) == 16u);
+  REQUIRE(SizeClassGrowth<>::SizeClass(100) == 112u);
+  REQUIRE(SizeClassGrowth<>::SizeClass(129) == 160u);
+  REQUIRE(SizeClassGrowth<>::SizeClass(1000) == 1024u);
+  REQUIRE(SizeClassGrowth<>::SizeClass(1025) == 1280u);
+  REQUIRE(Capacities<Vector<int, Alloc, SizeClassGrowth<>>>(20) == std::vector<size_t>{4, 8, 16, 32});
+
+  Vector<int, Alloc, OneAndHalfGrowth> v(10, 1);
+  v.Insert(v.begin(), 20, 2);
+  REQUIRE(v.Capacity() == 30u);
+  v.PushBack(3);
+  REQUIRE(v.Capacity() == 45u);
+}
+
+TEST_CASE("Reallocation counters", "[Growth]") {
+  Vector<int64_t, std::allocator<int64_t>, CountingGrowth<>> v;
+  REQUIRE(v.GetGrowthPolicy().Reallocations() == 0u);
+
+  for (int i = 0; i < 100; ++i) {
+    v.PushBack(i);
+  }
+  // 1, 2, 4, ..., 128
+  REQUIRE(v.GetGrowthPolicy().Reallocations() == 8u);
+  REQUIRE(v.GetGrowthPolicy().BytesMoved() == (1u + 2 + 4 + 8 + 16 + 32 + 64) * sizeof(int64_t));
+  REQUIRE(v.GetGrowthPolicy().PeakCapacity() == 128u);
+
+  v.Resize(10);
+  v.ShrinkToFit();
+  REQUIRE(v.GetGrowthPolicy().Reallocations() == 9u);
+  REQUIRE(v.GetGrowthPolicy().PeakCapacity() == 128u);
+
+  v.Reserve(5);
+  REQUIRE(v.GetGrowthPolicy().Reallocations() == 9u);
+
+  auto copy = v;
+  REQUIRE(copy.GetGrowthPolicy().Reallocations() == 0u);
+  auto moved = std::move(v);
+  REQUIRE(moved.GetGrowthPolicy().Reallocations() == 0u);
+  REQUIRE(v.GetGrowthPolicy().Reallocations() == 9u);
+
+  REQUIRE(sizeof(Vector<int>) == 3 * sizeof(size_t));
+}
@@ -0,0 +1,95 @@
+#include <catch.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "test_util.hpp"
+#include "huge_vector.hpp"
+
+TEST_CASE("HugeVector growth", "[Huge]") {
+  HugeVector<int64_t> v;
+  std::vector<int64_t> required;
+  for (int64_t i = 0; i < 1'000'000; ++i) {
+    v.PushBack(i * 3);
+    required.push_back(i * 3);
+  }
+  REQUIRE(v.Size() == required.size());
+  REQUIRE(std::equal(v.begin(), v.end(), required.begin()));
+
+  const auto copy = v;
+  REQUIRE(copy.Data() != v.Data());
+  REQUIRE(std::equal(copy.begin(), copy.end(), required.begin()));
+
+  v.Resize(10);
+  v.ShrinkToFit();
+  REQUIRE(v.Capacity() == 10u);
+  REQUIRE(v.Back() == 27);
+
+  v.Clear();
+  v.ShrinkToFit();
+  REQUIRE(v.Data() == nullptr);
+}
+
+#ifdef __linux__
+// MmapAllocator counting its calls, to see that growth goes through mremap
+struct MremapCalls {
+  static inline size_t allocate = 0;
+  static inline size_t reallocate = 0;
+};
+
+template <typename T>
+struct CountingMmapAllocator : MmapAllocator<T> {
+  CountingMmapAllocator() = default;
+
+  template <typename U>
+  CountingMmapAllocator(const CountingMmapAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    ++MremapCalls::allocate;
+    return MmapAllocator<T>::allocate(count);
+  }
+
+  T* reallocate(T* ptr, size_t old_count, size_t count) {
+    ++MremapCalls::reallocate;
+    return MmapAllocator<T>::reallocate(ptr, old_count, count);
+  }
+};
+
+TEST_CASE("HugeVector grows with mremap", "[Huge]") {
+  MremapCalls::allocate = 0;
+  MremapCalls::reallocate = 0;
+  Vector<int64_t, CountingMmapAllocator<int64_t>> v;
+  for (int64_t i = 0; i < 1'000'000; ++i) {
+    v.PushBack(i * 3);
+  }
+  REQUIRE(v[999'999] == 2'999'997);
+  // Only the first mapping is created, every later growth remaps it
+  REQUIRE(MremapCalls::allocate == 1u);
+  REQUIRE(MremapCalls::reallocate > 10u);
+
+  size_t reallocations = MremapCalls::reallocate;
+  v.Resize(10);
+  v.ShrinkToFit();
+  REQUIRE(v.Back() == 27);
+  REQUIRE(MremapCalls::reallocate == reallocations + 1);
+  REQUIRE(MremapCalls::allocate == 1u);
+}
+#endif
+
+TEST_CASE("HugeVector of non-trivial type", "[Huge]") {
+  InstanceCounter::counter = 0u;
+  {
+    HugeVector<std::string> v;
+    for (int i = 0; i < 10'000; ++i) {
+      v.PushBack(std::to_string(i));
+    }
+    REQUIRE(v[9'999] == "9999");
+    v.ShrinkToFit();
+    REQUIRE(v[1'234] == "1234");
+
+    HugeVector<InstanceCounter> counters(1000u);
+    counters.Reserve(100'000u);
+    REQUIRE(InstanceCounter::counter == 1000u);
+  }
+  REQUIRE(InstanceCounter::counter == 0u);
+}
@@ -0,0 +1,137 @@
+#include <catch.hpp>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "jagged_vector.hpp"
+
+template <typename T>
+static void RequireSame(const JaggedVector<T>& jagged, const std::vector<std::vector<T>>& expected) {
+  REQUIRE(jagged.Size() == expected.size());
+  size_t elements = 0;
+  for (size_t row = 0; row < expected.size(); ++row) {
+    std::span<const T> span = jagged[row];
+    REQUIRE(std::vector<T>(span.begin(), span.end()) == expected[row]);
+    REQUIRE(jagged.RowSize(row) <= jagged.RowCapacity(row));
+    elements += expected[row].size();
+  }
+  REQUIRE(jagged.ElementCount() == elements);
+}
+
+TEST_CASE("Jagged AppendRow", "[Jagged]") {
+  JaggedVector<int> jagged = {{1, 2, 3}, {}, {4}};
+  REQUIRE(jagged.Size() == 3u);
+  REQUIRE(jagged[0].size() == 3u);
+  REQUIRE(jagged[1].empty());
+  REQUIRE(jagged.At(2)[0] == 4);
+  REQUIRE_THROWS_AS(jagged.At(3), std::out_of_range);
+
+  // Rows appended one after another are adjacent
+  REQUIRE(jagged[0].data() + 3 == jagged[2].data());
+
+  jagged[0][1] = 20;
+  std::vector<int> row = {5, 6};
+  jagged.AppendRow(row.begin(), row.end());
+  jagged.AppendRow(jagged[0]);
+  RequireSame(jagged, {{1, 20, 3}, {}, {4}, {5, 6}, {1, 20, 3}});
+
+  jagged.Clear();
+  REQUIRE(jagged.Empty());
+  REQUIRE(jagged.ElementCount() == 0u);
+}
+
+TEST_CASE("Jagged FromCounts", "[Jagged]") {
+  // Two passes over an edge list: count the out-degrees, then fill the rows
+  std::mt19937 gen(1);
+  std::vector<std::pair<size_t, size_t>> edges;
+  for (int i = 0; i < 5000; ++i) {
+    edges.emplace_back(gen() % 300, gen() % 300);
+  }
+  std::vector<size_t> counts(300);
+  for (const auto& edge : edges) {
+    ++counts[edge.first];
+  }
+
+  auto jagged = JaggedVector<size_t>::FromCounts(counts);
+  REQUIRE(jagged.Size() == 300u);
+  REQUIRE(jagged.ElementCount() == 0u);
+  const size_t memory = jagged.MemoryBytes();
+  std::vector<std::vector<size_t>> expected(300);
+  for (const auto& edge : edges) {
+    jagged.PushBackToRow(edge.first, edge.second);
+    expected[edge.first].push_back(edge.second);
+  }
+  RequireSame(jagged, expected);
+  for (size_t row = 0; row < 300; ++row) {
+    REQUIRE(jagged.RowCapacity(row) == counts[row]);
+  }
+  // Filling exactly the counted room never moves a row
+  REQUIRE(jagged.MemoryBytes() == memory);
+}
+
+TEST_CASE("Jagged rows grow with slack", "[Jagged]") {
+  JaggedVector<std::string> jagged;
+  std::vector<std::vector<std::string>> expected(50);
+  for (size_t row = 0; row < 50; ++row) {
+    jagged.AppendEmptyRow(row % 3);
+  }
+
+  std::mt19937 gen(2);
+  for (int i = 0; i < 10000; ++i) {
+    size_t row = gen() % 50;
+    if (gen() % 10 == 0) {
+      jagged.PopBackFromRow(row);
+      if (!expected[row].empty()) {
+        expected[row].pop_back();
+      }
+    } else {
+      std::string value = std::to_string(i) + " long enough to be on the heap";
+      jagged.PushBackToRow(row, value);
+      expected[row].push_back(value);
+    }
+  }
+  RequireSame(jagged, expected);
+
+  // A row of the vector itself pushed into another one
+  jagged.PushBackToRow(7, jagged[3].empty() ? std::string("x") : jagged[3][0]);
+  expected[7].push_back(expected[3].empty() ? std::string("x") : expected[3][0]);
+  jagged.ClearRow(11);
+  expected[11].clear();
+  jagged.ReserveRow(12, 1000);
+  REQUIRE(jagged.RowCapacity(12) >= 1000u);
+  RequireSame(jagged, expected);
+
+  size_t before = jagged.MemoryBytes();
+  jagged.ShrinkToFit();
+  REQUIRE(jagged.MemoryBytes() < before);
+  RequireSame(jagged, expected);
+  for (size_t row = 0; row < 50; ++row) {
+    REQUIRE(jagged.RowCapacity(row) == jagged.RowSize(row));
+    if (row + 1 < 50) {
+      REQUIRE(jagged[row].data() + jagged.RowSize(row) == jagged[row + 1].data());
+    }
+  }
+}
+
+TEST_CASE("Jagged copy and move", "[Jagged]") {
+  JaggedVector<std::shared_ptr<int>> jagged;
+  jagged.AppendEmptyRow();
+  jagged.AppendEmptyRow();
+  for (int i = 0; i < 100; ++i) {
+    jagged.PushBackToRow(static_cast<size_t>(i % 2), std::make_shared<int>(i));
+  }
+
+  JaggedVector<std::shared_ptr<int>> copy = jagged;
+  REQUIRE(copy[1][10] == jagged[1][10]);
+  REQUIRE(copy[1][10].use_count() == 2);
+
+  JaggedVector<std::shared_ptr<int>> moved = std::move(copy);
+  REQUIRE(*moved[0][49] == 98);
+  moved.Swap(jagged);
+  jagged.PopBackFromRow(0);
+  REQUIRE(jagged.RowSize(0) == 49u);
+  REQUIRE(moved.RowSize(0) == 50u);
+  REQUIRE(moved[0][49].use_count() == 1);
+}
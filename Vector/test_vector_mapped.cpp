@@ -0,0 +1,110 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "mapped_vector.hpp"
+
+struct Sample {
+  int64_t time;
+  double value;
+};
+
+// A fresh file in the temporary directory, removed at the end of the test
+struct TempFile {
+  std::string path;
+
+  explicit TempFile(const std::string& name)
+      : path((std::filesystem::temp_directory_path() / name).string()) {
+    std::filesystem::remove(path);
+  }
+
+  ~TempFile() {
+    std::filesystem::remove(path);
+  }
+
+  size_t Bytes() const {
+    return static_cast<size_t>(std::filesystem::file_size(path));
+  }
+};
+
+TEST_CASE("Mapped append and reopen", "[Mapped]") {
+  TempFile file("test_vector_mapped_samples");
+  {
+    MappedVector<Sample> v(file.path);
+    REQUIRE(v.Empty());
+    REQUIRE(v.Data() == nullptr);
+    for (int i = 0; i < 10000; ++i) {
+      v.PushBack({i, i * 0.5});
+    }
+    REQUIRE(v.Size() == 10000u);
+    REQUIRE(v.Capacity() >= v.Size());
+    REQUIRE(file.Bytes() == v.Capacity() * sizeof(Sample));
+  }
+  REQUIRE(file.Bytes() == 10000 * sizeof(Sample));
+
+  {
+    MappedVector<Sample> v(file.path);
+    REQUIRE(v.Size() == 10000u);
+    REQUIRE(v[9999].time == 9999);
+    REQUIRE(v.Back().value == 9999 * 0.5);
+
+    v.Resize(5);
+    v.PushBack(v[0]);
+    v.Sync();
+    REQUIRE(v.Capacity() == 6u);
+    REQUIRE(file.Bytes() == 6 * sizeof(Sample));
+  }
+
+  MappedVector<Sample> v(file.path, MappedVector<Sample>::Mode::kReadOnly);
+  REQUIRE(v.IsReadOnly());
+  REQUIRE(v.Size() == 6u);
+  REQUIRE(v[4].time == 4);
+  REQUIRE(v[5].time == 0);
+}
+
+TEST_CASE("Mapped Resize", "[Mapped]") {
+  TempFile file("test_vector_mapped_ints");
+  MappedVector<int> v(file.path);
+  v.Resize(100, 7);
+  REQUIRE(v[99] == 7);
+
+  // The bytes behind the last element are still 7, Resize has to clear them
+  v.Resize(10);
+  v.Resize(200);
+  REQUIRE(v[9] == 7);
+  REQUIRE(v[10] == 0);
+  REQUIRE(v[199] == 0);
+
+  int data[] = {1, 2, 3};
+  v.Clear();
+  v.AppendRange(std::begin(data), std::end(data));
+  REQUIRE(v.Size() == 3u);
+  REQUIRE(v.At(2) == 3);
+  REQUIRE_THROWS_AS(v.At(3), std::out_of_range);
+
+  MappedVector<int> moved = std::move(v);
+  REQUIRE(moved.Size() == 3u);
+  REQUIRE(v.Size() == 0u);
+  moved.ShrinkToFit();
+  REQUIRE(file.Bytes() == 3 * sizeof(int));
+}
+
+TEST_CASE("Mapped errors", "[Mapped]") {
+  TempFile file("test_vector_mapped_errors");
+  REQUIRE_THROWS_AS(MappedVector<int>(file.path, MappedVector<int>::Mode::kReadOnly), std::system_error);
+
+  {
+    MappedVector<char> bytes(file.path);
+    bytes.Resize(5);
+  }
+  REQUIRE_THROWS_AS(MappedVector<int>(file.path), std::runtime_error);
+
+  MappedVector<char> read_only(file.path, MappedVector<char>::Mode::kReadOnly);
+  REQUIRE(read_only.Size() == 5u);
+  REQUIRE_THROWS_AS(read_only.PushBack('a'), std::logic_error);
+  REQUIRE_THROWS_AS(read_only.Resize(1), std::logic_error);
+  REQUIRE_THROWS_AS(read_only.Sync(), std::logic_error);
+}
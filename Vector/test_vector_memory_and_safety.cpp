@@ -13,39 +13,39 @@ TEST_CASE("ConstructorsAndDestructors", "[Memory]") {
   InstanceCounter::counter = 0u;
 
   SECTION("Default Constructor") {
-    const Vector<InstanceCounter> v;
+    const TestVector<InstanceCounter> v;
     REQUIRE(InstanceCounter::counter == 0u);
   }
 
   SECTION("Size Constructor") {
-    const Vector<InstanceCounter> v(10u);
+    const TestVector<InstanceCounter> v(10u);
     REQUIRE(InstanceCounter::counter == 10u);
   }
 
   SECTION("Size-Value Constructor") {
-    const Vector<InstanceCounter> v(10u, InstanceCounter{});
+    const TestVector<InstanceCounter> v(10u, InstanceCounter{});
     REQUIRE(InstanceCounter::counter == 10u);
   }
 
   SECTION("Iterators Constructor") {
     const std::vector<InstanceCounter> values(100u);
-    const Vector<InstanceCounter> v(values.begin(), values.end());
+    const TestVector<InstanceCounter> v(values.begin(), values.end());
     REQUIRE(InstanceCounter::counter == 200u);
   }
 
   SECTION("Initializer List Constructor") {
-    const Vector<InstanceCounter> v{InstanceCounter{}, InstanceCounter{}, InstanceCounter{}};
+    const TestVector<InstanceCounter> v{InstanceCounter{}, InstanceCounter{}, InstanceCounter{}};
     REQUIRE(InstanceCounter::counter == 3u);
   }
 
   SECTION("Copy Constructor") {
-    const Vector<InstanceCounter> values(100u);
+    const TestVector<InstanceCounter> values(100u);
     const auto v = values;
     REQUIRE(InstanceCounter::counter == 200u);
   }
 
   SECTION("Move Constructor") {
-    Vector<InstanceCounter> values(100u);
+    TestVector<InstanceCounter> values(100u);
     const auto v = std::move(values);
     REQUIRE(InstanceCounter::counter == 100u);
   }
@@ -58,16 +58,16 @@ TEST_CASE("Assignment Memory", "[Memory]") {
 
   SECTION("Copy Assignment") {
     {
-      const Vector<InstanceCounter> values(10u);
-      Vector<InstanceCounter> v(100u);
+      const TestVector<InstanceCounter> values(10u);
+      TestVector<InstanceCounter> v(100u);
       v = values;
       REQUIRE(InstanceCounter::counter == 20u);
     }
     REQUIRE(InstanceCounter::counter == 0u);
 
     {
-      const Vector<InstanceCounter> values(100u);
-      Vector<InstanceCounter> v(10u);
+      const TestVector<InstanceCounter> values(100u);
+      TestVector<InstanceCounter> v(10u);
       v = values;
       REQUIRE(InstanceCounter::counter == 200u);
     }
@@ -75,16 +75,16 @@ TEST_CASE("Assignment Memory", "[Memory]") {
 
   SECTION("Move Assignment") {
     {
-      Vector<InstanceCounter> values(10u);
-      Vector<InstanceCounter> v(100u);
+      TestVector<InstanceCounter> values(10u);
+      TestVector<InstanceCounter> v(100u);
       v = std::move(values);
       REQUIRE(InstanceCounter::counter == 10u);
     }
     REQUIRE(InstanceCounter::counter == 0u);
 
     {
-      Vector<InstanceCounter> values(100u);
-      Vector<InstanceCounter> v(10u);
+      TestVector<InstanceCounter> values(100u);
+      TestVector<InstanceCounter> v(10u);
       v = std::move(values);
       REQUIRE(InstanceCounter::counter == 100u);
     }
@@ -97,16 +97,16 @@ TEST_CASE("Swap Memory", "[Memory]") {
   InstanceCounter::counter = 0u;
 
   {
-    Vector<InstanceCounter> a;
-    Vector<InstanceCounter> b(10u);
+    TestVector<InstanceCounter> a;
+    TestVector<InstanceCounter> b(10u);
     a.Swap(b);
     REQUIRE(InstanceCounter::counter == 10u);
   }
   REQUIRE(InstanceCounter::counter == 0u);
 
   {
-    Vector<InstanceCounter> a(20u);
-    Vector<InstanceCounter> b(10u);
+    TestVector<InstanceCounter> a(20u);
+    TestVector<InstanceCounter> b(10u);
     a.Swap(b);
     REQUIRE(InstanceCounter::counter == 30u);
   }
@@ -116,7 +116,7 @@ TEST_CASE("Swap Memory", "[Memory]") {
 TEST_CASE("Clear Memory", "[Memory]") {
   InstanceCounter::counter = 0u;
 
-  Vector<InstanceCounter> v(10u);
+  TestVector<InstanceCounter> v(10u);
   v.Clear();
   REQUIRE(InstanceCounter::counter == 0u);
 }
@@ -125,7 +125,7 @@ TEST_CASE("Resize Memory", "[Memory]") {
   InstanceCounter::counter = 0u;
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     v.Resize(100u);
     REQUIRE(InstanceCounter::counter == 100u);
     v.Resize(10u);
@@ -136,7 +136,7 @@ TEST_CASE("Resize Memory", "[Memory]") {
   REQUIRE(InstanceCounter::counter == 0u);
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     v.Resize(100u, InstanceCounter{});
     REQUIRE(InstanceCounter::counter == 100u);
     v.Resize(10u, InstanceCounter{});
@@ -151,7 +151,7 @@ TEST_CASE("Reserve Memory", "[Memory]") {
   InstanceCounter::counter = 0u;
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     v.Reserve(100u);
     REQUIRE(InstanceCounter::counter == 0u);
     v.Resize(10u);
@@ -168,7 +168,7 @@ TEST_CASE("ShrinkToFit Memory", "[Memory]") {
   InstanceCounter::counter = 0u;
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     v.Reserve(100u);
     REQUIRE(InstanceCounter::counter == 0u);
     v.Resize(10u);
@@ -190,7 +190,7 @@ TEST_CASE("PushBack Memory", "[Memory]") {
   InstanceCounter::counter = 0u;
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     for (size_t i = 0; i < 100; ++i) {
       v.PushBack({});
       REQUIRE(InstanceCounter::counter == (i + 1));
@@ -199,7 +199,7 @@ TEST_CASE("PushBack Memory", "[Memory]") {
   REQUIRE(InstanceCounter::counter == 0u);
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     InstanceCounter obj;
     for (size_t i = 0; i < 100; ++i) {
       v.PushBack(obj);
@@ -211,7 +211,7 @@ TEST_CASE("PushBack Memory", "[Memory]") {
 
 TEST_CASE("PushBack From Itself Memory", "[Memory]") {
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     InstanceCounter obj;
     v.PushBack(obj);
     for (size_t i = 0; i < 100; ++i) {
@@ -222,7 +222,7 @@ TEST_CASE("PushBack From Itself Memory", "[Memory]") {
   REQUIRE(InstanceCounter::counter == 0u);
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     InstanceCounter obj;
     v.PushBack(obj);
     for (size_t i = 0; i < 100; ++i) {
@@ -237,7 +237,7 @@ TEST_CASE("EmplaceBack Memory", "[Memory]") {
   InstanceCounter::counter = 0u;
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     for (size_t i = 0; i < 100; ++i) {
       v.EmplaceBack();
       REQUIRE(InstanceCounter::counter == (i + 1));
@@ -246,7 +246,7 @@ TEST_CASE("EmplaceBack Memory", "[Memory]") {
   REQUIRE(InstanceCounter::counter == 0u);
 
   {
-    Vector<std::vector<int>> v;
+    TestVector<std::vector<int>> v;
     for (size_t i = 0; i < 10; ++i) {
       v.EmplaceBack();
       REQUIRE(v.Size() == static_cast<unsigned>(i + 1));
@@ -275,7 +275,7 @@ TEST_CASE("PopBack Memory", "[Memory]") {
   InstanceCounter::counter = 0u;
 
   {
-    Vector<InstanceCounter> v;
+    TestVector<InstanceCounter> v;
     for (int i = 0; i < 100; ++i) {
       v.PushBack({});
     }
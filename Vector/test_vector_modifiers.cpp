@@ -0,0 +1,254 @@
+#include <catch.hpp>
+#include <cstring>
+#include <list>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iterator>
+
+#include "test_util.hpp"
+#include "vector.hpp"
+
+struct CopyCounter {
+  static size_t copies;
+  static size_t moves;
+
+  CopyCounter() = default;
+
+  CopyCounter(const CopyCounter&) {
+    ++copies;
+  }
+
+  CopyCounter(CopyCounter&&) noexcept {
+    ++moves;
+  }
+
+  CopyCounter& operator=(const CopyCounter&) = default;
+  CopyCounter& operator=(CopyCounter&&) noexcept = default;
+};
+
+size_t CopyCounter::copies = 0u;
+size_t CopyCounter::moves = 0u;
+
+template <typename T>
+struct CountingAllocator : std::allocator<T> {
+  static size_t allocations;
+
+  template <typename U>
+  struct rebind {
+    using other = CountingAllocator<U>;
+  };
+
+  CountingAllocator() = default;
+
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    ++allocations;
+    return std::allocator<T>::allocate(count);
+  }
+};
+
+template <typename T>
+size_t CountingAllocator<T>::allocations = 0u;
+
+TEST_CASE("Perfect forwarding", "[Modifiers]") {
+  Vector<CopyCounter> v;
+  v.Reserve(10);
+  const CopyCounter elem;
+
+  CopyCounter::copies = 0u;
+  CopyCounter::moves = 0u;
+  v.PushBack(elem);
+  REQUIRE(CopyCounter::copies == 1u);
+  REQUIRE(CopyCounter::moves == 0u);
+
+  v.PushBack(CopyCounter{});
+  REQUIRE(CopyCounter::copies == 1u);
+  REQUIRE(CopyCounter::moves == 1u);
+
+  v.EmplaceBack();
+  REQUIRE(CopyCounter::copies == 1u);
+  REQUIRE(CopyCounter::moves == 1u);
+
+  Vector<std::unique_ptr<int>> pointers;
+  pointers.EmplaceBack(std::make_unique<int>(5));
+  pointers.PushBack(std::make_unique<int>(6));
+  REQUIRE(*pointers[0] == 5);
+  REQUIRE(*pointers[1] == 6);
+}
+
+TEST_CASE("Emplace", "[Modifiers]") {
+  Vector<std::string> v;
+  std::vector<std::string> required;
+  for (int i = 0; i < 100; ++i) {
+    size_t pos = (i * 7) % (v.Size() + 1);
+    auto it = v.Emplace(v.begin() + pos, 3, static_cast<char>('a' + i % 26));
+    required.emplace(required.begin() + pos, 3, static_cast<char>('a' + i % 26));
+    REQUIRE(it == v.begin() + pos);
+    Equal(v, required);
+  }
+
+  v.Insert(v.begin(), v.Back());
+  required.insert(required.begin(), required.back());
+  v.Insert(v.begin() + 5, std::string("moved"));
+  required.insert(required.begin() + 5, "moved");
+  Equal(v, required);
+}
+
+TEST_CASE("Insert count", "[Modifiers]") {
+  Vector<int> v{1, 2, 3, 4, 5};
+  v.Reserve(100);
+  const auto data = v.Data();
+
+  v.Insert(v.begin() + 1, 2, 0);
+  Equal(v, {1, 0, 0, 2, 3, 4, 5});
+  v.Insert(v.begin() + 5, 4, 9);
+  Equal(v, {1, 0, 0, 2, 3, 9, 9, 9, 9, 4, 5});
+  v.Insert(v.end(), 1, 7);
+  v.Insert(v.begin(), 0, 7);
+  Equal(v, {1, 0, 0, 2, 3, 9, 9, 9, 9, 4, 5, 7});
+  REQUIRE(v.Data() == data);
+
+  v.Insert(v.begin() + 2, 200, v[0]);
+  REQUIRE(v.Size() == 212u);
+  REQUIRE(v[1] == 0);
+  REQUIRE(v[2] == 1);
+  REQUIRE(v[201] == 1);
+  REQUIRE(v[202] == 0);
+}
+
+TEST_CASE("Insert range", "[Modifiers]") {
+  SECTION("Forward iterators") {
+    Vector<std::string> v{"a", "b", "c"};
+    std::vector<std::string> required{"a", "b", "c"};
+    const std::list<std::string> values{"x", "y", "z", "w"};
+
+    for (size_t pos : {0u, 2u, 5u, 11u, 1u}) {
+      v.Reserve(v.Size() + (pos % 2 == 1 ? 8 : 2));
+      v.Insert(v.begin() + pos, values.begin(), values.end());
+      required.insert(required.begin() + pos, values.begin(), values.end());
+      Equal(v, required);
+    }
+
+    v.Insert(v.begin() + 3, {"1", "2"});
+    required.insert(required.begin() + 3, {"1", "2"});
+    Equal(v, required);
+  }
+
+  SECTION("Input iterators") {
+    Vector<int> v{1, 2, 3};
+    std::istringstream input("4 5 6 7");
+    v.Insert(v.begin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+    Equal(v, {1, 4, 5, 6, 7, 2, 3});
+  }
+
+  SECTION("Single reallocation") {
+    Vector<int> v{1, 2};
+    const std::vector<int> values(1000, 3);
+    v.AppendRange(values.begin(), values.end());
+    REQUIRE(v.Size() == 1002u);
+    REQUIRE(v.Capacity() == 1002u);
+    REQUIRE(v[1] == 2);
+    REQUIRE(v[1001] == 3);
+  }
+}
+
+TEST_CASE("Erase", "[Modifiers]") {
+  Vector<std::string> v;
+  std::vector<std::string> required;
+  for (int i = 0; i < 50; ++i) {
+    v.PushBack(std::to_string(i));
+    required.push_back(std::to_string(i));
+  }
+
+  auto it = v.Erase(v.begin() + 10);
+  required.erase(required.begin() + 10);
+  REQUIRE(*it == "11");
+  Equal(v, required);
+
+  it = v.Erase(v.begin(), v.begin() + 5);
+  required.erase(required.begin(), required.begin() + 5);
+  REQUIRE(*it == "5");
+  Equal(v, required);
+
+  it = v.Erase(v.begin() + 30, v.end());
+  required.erase(required.begin() + 30, required.end());
+  REQUIRE(it == v.end());
+  Equal(v, required);
+
+  v.Erase(v.begin() + 3, v.begin() + 3);
+  Equal(v, required);
+}
+
+TEST_CASE("Resize in place", "[Modifiers]") {
+  using Strings = Vector<std::string, CountingAllocator<std::string>>;
+  Strings v{"a", "b"};
+
+  CountingAllocator<std::string>::allocations = 0u;
+  v.Resize(100u, v[1]);
+  REQUIRE(CountingAllocator<std::string>::allocations == 1u);
+  REQUIRE(v.Capacity() == 100u);
+  REQUIRE(v[99] == "b");
+
+  v.Resize(50u);
+  v.Resize(80u);
+  v.Resize(90u, "c");
+  REQUIRE(CountingAllocator<std::string>::allocations == 1u);
+  REQUIRE(v[49] == "b");
+  REQUIRE(v[50].empty());
+  REQUIRE(v[89] == "c");
+}
+
+TEST_CASE("ResizeUninitialized", "[Modifiers]") {
+  Vector<uint8_t> v{1, 2, 3};
+  v.ResizeUninitialized(1000u);
+  REQUIRE(v.Size() == 1000u);
+  REQUIRE(v.Capacity() == 1000u);
+  Equal(Vector<uint8_t>(v.begin(), v.begin() + 3), {1, 2, 3});
+
+  std::memset(v.Data() + 3, 7, 997);
+  const auto data = v.Data();
+  v.ResizeUninitialized(10u);
+  v.ResizeUninitialized(500u);
+  REQUIRE(v.Data() == data);
+  REQUIRE(v[499] == 7);
+}
+
+TEST_CASE("Modifiers [Memory]") {
+  InstanceCounter::counter = 0u;
+  {
+    Vector<InstanceCounter> v(10u);
+    v.Insert(v.begin() + 3, 5u, InstanceCounter{});
+    REQUIRE(InstanceCounter::counter == 15u);
+    v.Emplace(v.begin());
+    REQUIRE(InstanceCounter::counter == 16u);
+    v.Erase(v.begin() + 2, v.begin() + 8);
+    REQUIRE(InstanceCounter::counter == 10u);
+    const std::vector<InstanceCounter> values(7u);
+    v.AppendRange(values.begin(), values.end());
+    REQUIRE(InstanceCounter::counter == 24u);
+  }
+  REQUIRE(InstanceCounter::counter == 0u);
+}
+
+TEST_CASE("Modifiers Safety", "[Safety]") {
+  Throwable::until_throw = 100;
+  Vector<Throwable> v(10u);
+  const std::vector<Throwable> values(20u);
+  const auto data = v.Data();
+  const auto capacity = v.Capacity();
+
+  Throwable::until_throw = 5;
+  REQUIRE_THROWS_AS(v.Insert(v.begin() + 3, values.begin(), values.end()), Exception);
+  REQUIRE(v.Size() == 10u);
+  REQUIRE(v.Data() == data);
+  REQUIRE(v.Capacity() == capacity);
+
+  Throwable::until_throw = 1;
+  REQUIRE_THROWS_AS(v.EmplaceBack(), Exception);
+  REQUIRE(v.Size() == 10u);
+  REQUIRE(v.Data() == data);
+  Throwable::until_throw = std::numeric_limits<int>::max();
+}
@@ -0,0 +1,125 @@
+#include <catch.hpp>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "test_util.hpp"
+#include "parallel_vector.hpp"
+
+// Threshold 1 sends even the smallest range to the pool
+const ParallelExecution kParallel{1, 4};
+
+// Throwable and InstanceCounter count in plain statics, this one is safe to build from many threads
+struct Record {
+  static std::atomic<int> instances;
+  int value = 0;
+
+  Record(int value = 0) : value(value) {
+    ++instances;
+  }
+
+  Record(const Record& other) : value(other.value) {
+    if (other.value < 0) {
+      throw Exception{};
+    }
+    ++instances;
+  }
+
+  Record& operator=(const Record&) = default;
+
+  ~Record() {
+    --instances;
+  }
+};
+
+std::atomic<int> Record::instances{0};
+
+TEST_CASE("ParallelFor chunks", "[Parallel]") {
+  std::vector<std::atomic<int>> visits(1000);
+  ParallelFor(visits.size(), kParallel, [&visits](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      ++visits[i];
+    }
+  }, [](size_t, size_t) {});
+  for (auto& visit : visits) {
+    REQUIRE(visit == 1);
+  }
+
+  size_t calls = 0;
+  ParallelFor(1000, ParallelExecution{2000, 4}, [&calls](size_t begin, size_t end) {
+    ++calls;
+    REQUIRE(begin == 0u);
+    REQUIRE(end == 1000u);
+  }, [](size_t, size_t) {});
+  REQUIRE(calls == 1u);
+}
+
+TEST_CASE("Parallel construction", "[Parallel]") {
+  const auto filled = MakeParallel<std::string>(1001, "abc", kParallel);
+  REQUIRE(filled.Size() == 1001u);
+  REQUIRE(filled.Capacity() == 1001u);
+  for (const auto& elem : filled) {
+    REQUIRE(elem == "abc");
+  }
+
+  std::vector<int> values(777);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<int>(i * i);
+  }
+  const auto range = MakeParallel(values.begin(), values.end(), kParallel);
+  Equal(range, values);
+
+  const auto copy = MakeParallel(range, kParallel);
+  Equal(copy, values);
+  REQUIRE(copy.Data() != range.Data());
+
+  Vector<int> empty;
+  const auto empty_copy = MakeParallel(empty, kParallel);
+  REQUIRE(empty_copy.Size() == 0u);
+  REQUIRE(empty_copy.Data() == nullptr);
+}
+
+TEST_CASE("Parallel Resize and Fill", "[Parallel]") {
+  Vector<std::string> v{"a", "b"};
+  ParallelResize(v, 500, v[1], kParallel);
+  REQUIRE(v.Size() == 500u);
+  REQUIRE(v[0] == "a");
+  REQUIRE(v[499] == "b");
+
+  const auto data = v.Data();
+  ParallelResize(v, 100, "c", kParallel);
+  ParallelResize(v, 400, "d", kParallel);
+  REQUIRE(v.Data() == data);
+  REQUIRE(v[99] == "b");
+  REQUIRE(v[100] == "d");
+
+  ParallelFill(v, "e", kParallel);
+  for (const auto& elem : v) {
+    REQUIRE(elem == "e");
+  }
+  v.Fill("f");
+  REQUIRE(v[0] == "f");
+  REQUIRE(v[399] == "f");
+}
+
+TEST_CASE("Parallel Safety", "[Parallel]") {
+  Record::instances = 0;
+  {
+    std::vector<Record> values(1000);
+    values[600].value = -1;
+
+    REQUIRE_THROWS_AS(MakeParallel(values.begin(), values.end(), kParallel), Exception);
+    REQUIRE(Record::instances == 1000);
+
+    Vector<Record> v(10);
+    const auto data = v.Data();
+    REQUIRE_THROWS_AS(ParallelResize(v, 1000, Record(-1), kParallel), Exception);
+    REQUIRE(v.Size() == 10u);
+    REQUIRE(v.Data() == data);
+    REQUIRE(Record::instances == 1010);
+
+    REQUIRE_THROWS_AS(MakeParallel<Record>(1000, Record(-1), kParallel), Exception);
+    REQUIRE(Record::instances == 1010);
+  }
+  REQUIRE(Record::instances == 0);
+}
@@ -0,0 +1,128 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "persistent_vector.hpp"
+
+TEST_CASE("Persistent PushBack keeps old versions", "[Persistent]") {
+  PersistentVector<int> empty;
+  REQUIRE(empty.Empty());
+
+  std::vector<PersistentVector<int>> versions = {empty};
+  // Deep enough for three levels of branches
+  for (int i = 0; i < 40000; ++i) {
+    versions.push_back(versions.back().PushBack(i));
+  }
+
+  REQUIRE(empty.Size() == 0u);
+  for (size_t size : {1u, 31u, 32u, 33u, 1024u, 1056u, 1057u, 32800u, 40000u}) {
+    const auto& version = versions[size];
+    REQUIRE(version.Size() == size);
+    REQUIRE(version.Front() == 0);
+    REQUIRE(version.Back() == static_cast<int>(size) - 1);
+    REQUIRE(version[size / 2] == static_cast<int>(size / 2));
+  }
+
+  const auto& last = versions.back();
+  for (size_t i = 0; i < last.Size(); ++i) {
+    REQUIRE(last[i] == static_cast<int>(i));
+  }
+  REQUIRE_THROWS_AS(last.At(40000), std::out_of_range);
+}
+
+TEST_CASE("Persistent Set and PopBack", "[Persistent]") {
+  auto transient = PersistentVector<std::string>().AsTransient();
+  for (int i = 0; i < 5000; ++i) {
+    transient.PushBack(std::to_string(i));
+  }
+  const auto original = transient.Persistent();
+
+  auto changed = original.Set(17, "seventeen").Set(4999, "last");
+  REQUIRE(changed[17] == "seventeen");
+  REQUIRE(changed[4999] == "last");
+  REQUIRE(original[17] == "17");
+  REQUIRE(original[4999] == "4999");
+  REQUIRE_THROWS_AS(original.Set(5000, "out"), std::out_of_range);
+
+  // Down through every tail and level boundary to empty
+  auto shrinking = original;
+  for (size_t size = 5000; size > 0; --size) {
+    REQUIRE(shrinking.Size() == size);
+    REQUIRE(shrinking.Back() == std::to_string(size - 1));
+    shrinking = shrinking.PopBack();
+  }
+  REQUIRE(shrinking.Empty());
+  REQUIRE(shrinking.PushBack("again")[0] == "again");
+  REQUIRE(original.Size() == 5000u);
+  REQUIRE(original[2500] == "2500");
+}
+
+TEST_CASE("Transient batch edits", "[Persistent]") {
+  const PersistentVector<int> base = {1, 2, 3};
+  auto transient = base.AsTransient();
+  for (int i = 0; i < 10000; ++i) {
+    transient.PushBack(i);
+  }
+  transient.Set(0, -1);
+  transient.PopBack();
+
+  auto first = transient.Persistent();
+  transient.Set(1, -2);
+  transient.PushBack(100);
+  auto second = transient.Persistent();
+
+  REQUIRE(base.Size() == 3u);
+  REQUIRE(base[0] == 1);
+  REQUIRE(first.Size() == 10002u);
+  REQUIRE(first[0] == -1);
+  REQUIRE(first[1] == 2);
+  REQUIRE(first.Back() == 9998);
+  REQUIRE(second[1] == -2);
+  REQUIRE(second.Back() == 100);
+
+  std::vector<int> copied(first.begin(), first.end());
+  REQUIRE(copied.size() == first.Size());
+  REQUIRE(std::equal(copied.begin(), copied.end(), first.begin()));
+  REQUIRE(first.end() - first.begin() == 10002);
+  REQUIRE(first.begin()[3] == 0);
+}
+
+TEST_CASE("Persistent snapshots read from threads", "[Persistent]") {
+  PersistentVector<int> vec;
+  for (int i = 0; i < 1000; ++i) {
+    vec = vec.PushBack(i);
+  }
+
+  // Catch assertions aren't thread safe, readers count mismatches instead
+  std::atomic<bool> stop{false};
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> readers;
+  const PersistentVector<int> snapshot = vec;
+  for (int t = 0; t < 4; ++t) {
+    readers.emplace_back([&snapshot, &stop, &mismatches] {
+      while (!stop.load()) {
+        for (int i = 0; i < 1000; ++i) {
+          if (snapshot[static_cast<size_t>(i)] != i) {
+            ++mismatches;
+          }
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 1000; ++i) {
+    vec = vec.Set(static_cast<size_t>(i), -i).PushBack(i);
+  }
+  stop.store(true);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  REQUIRE(mismatches == 0);
+  REQUIRE(vec.Size() == 2000u);
+  REQUIRE(vec[999] == -999);
+  REQUIRE(snapshot[999] == 999);
+}
@@ -0,0 +1,161 @@
+#include <catch.hpp>
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include <cstddef>
+
+#include "test_util.hpp"
+#include "vector.hpp"
+#include "malloc_allocator.hpp"
+
+struct Point {
+  int x = 0;
+  double y = 0;
+};
+
+// Owns a resource but never points into itself, so it's safe to memcpy around
+struct Handle {
+  std::unique_ptr<int> p;
+
+  Handle() = default;
+  explicit Handle(int value) : p(std::make_unique<int>(value)) {
+  }
+};
+
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {};
+
+TEST_CASE("Relocation traits", "[Relocation]") {
+  REQUIRE(IsTriviallyRelocatable<int>::value);
+  REQUIRE(IsTriviallyRelocatable<Point>::value);
+  REQUIRE(IsTriviallyRelocatable<Handle>::value);
+  REQUIRE_FALSE(IsTriviallyRelocatable<std::vector<int>>::value);
+  REQUIRE_FALSE(HasReallocate<std::allocator<int>>::value);
+  REQUIRE(HasReallocate<MallocAllocator<int>>::value);
+}
+
+TEST_CASE("Trivially copyable", "[Relocation]") {
+  Vector<Point> v;
+  for (int i = 0; i < 1000; ++i) {
+    v.PushBack({i, i / 2.0});
+    REQUIRE(v.Capacity() >= v.Size());
+  }
+
+  const auto copy = v;
+  REQUIRE(copy.Size() == 1000u);
+  REQUIRE(copy.Capacity() == v.Capacity());
+  REQUIRE(copy.Data() != v.Data());
+
+  v.Resize(10);
+  v.ShrinkToFit();
+  REQUIRE(v.Capacity() == 10u);
+  for (int i = 0; i < 1000; ++i) {
+    REQUIRE(copy[i].x == i);
+    REQUIRE(copy[i].y == i / 2.0);
+  }
+  for (int i = 0; i < 10; ++i) {
+    REQUIRE(v[i].x == i);
+  }
+
+  v.Clear();
+  v.ShrinkToFit();
+  REQUIRE(v.Capacity() == 0u);
+  REQUIRE(v.Data() == nullptr);
+}
+
+TEST_CASE("Specialized relocatable type", "[Relocation]") {
+  Vector<Handle> v;
+  for (int i = 0; i < 100; ++i) {
+    v.EmplaceBack(i);
+  }
+  v.Reserve(1000);
+  v.ShrinkToFit();
+  REQUIRE(v.Capacity() == 100u);
+  for (int i = 0; i < 100; ++i) {
+    REQUIRE(*v[i].p == i);
+  }
+}
+
+// MallocAllocator counting its calls, to see which way Vector grows
+struct ReallocCalls {
+  static inline size_t allocate = 0;
+  static inline size_t reallocate = 0;
+};
+
+template <typename T>
+struct CountingMallocAllocator : MallocAllocator<T> {
+  CountingMallocAllocator() = default;
+
+  template <typename U>
+  CountingMallocAllocator(const CountingMallocAllocator<U>&) {}
+
+  T* allocate(size_t count) {
+    ++ReallocCalls::allocate;
+    return MallocAllocator<T>::allocate(count);
+  }
+
+  T* reallocate(T* ptr, size_t old_count, size_t count) {
+    ++ReallocCalls::reallocate;
+    return MallocAllocator<T>::reallocate(ptr, old_count, count);
+  }
+};
+
+TEST_CASE("PushBack grows with reallocate", "[Relocation]") {
+  ReallocCalls::allocate = 0;
+  ReallocCalls::reallocate = 0;
+  Vector<int, CountingMallocAllocator<int>> v;
+  for (int i = 0; i < 100'000; ++i) {
+    v.PushBack(i);
+  }
+  // Only the first block is allocated, every later growth resizes it
+  REQUIRE(ReallocCalls::allocate == 1u);
+  REQUIRE(ReallocCalls::reallocate > 10u);
+
+  // Elements of the vector itself, pushed while it is full
+  for (int i = 0; i < 5; ++i) {
+    v.ShrinkToFit();
+    size_t reallocations = ReallocCalls::reallocate;
+    v.PushBack(v[7]);
+    REQUIRE(ReallocCalls::reallocate == reallocations + 1);
+    v.ShrinkToFit();
+    v.EmplaceBack(v.Back());
+  }
+  for (size_t i = v.Size() - 10; i < v.Size(); ++i) {
+    REQUIRE(v[i] == 7);
+  }
+  REQUIRE(ReallocCalls::allocate == 1u);
+}
+
+TEST_CASE("Realloc growth", "[Relocation]") {
+  ReallocCalls::allocate = 0;
+  ReallocCalls::reallocate = 0;
+  Vector<int, CountingMallocAllocator<int>> v;
+  std::vector<int> required;
+  for (int i = 0; i < 100'000; ++i) {
+    v.PushBack(i);
+    required.push_back(i);
+  }
+  REQUIRE(v.Size() == required.size());
+  REQUIRE(std::equal(v.begin(), v.end(), required.begin()));
+  REQUIRE(ReallocCalls::allocate == 1u);
+  REQUIRE(ReallocCalls::reallocate > 0u);
+
+  size_t reallocations = ReallocCalls::reallocate;
+  v.Resize(3);
+  v.ShrinkToFit();
+  REQUIRE(v.Capacity() == 3u);
+  REQUIRE(v[2] == 2);
+  REQUIRE(ReallocCalls::reallocate == reallocations + 1);
+
+  auto copy = v;
+  REQUIRE(ReallocCalls::allocate == 2u);
+  copy.PushBack(3);
+  REQUIRE(copy.Size() == 4u);
+  REQUIRE(v.Size() == 3u);
+  REQUIRE(ReallocCalls::allocate == 2u);
+  REQUIRE(ReallocCalls::reallocate == reallocations + 2);
+
+  v.Clear();
+  v.ShrinkToFit();
+  REQUIRE(v.Data() == nullptr);
+}
@@ -10,8 +10,8 @@
 
 
 TEST_CASE("std::move_if_noexcept") {
-  Vector<MoveThrowable> v{MoveThrowable{}};
-  Vector<MoveThrowable> move_constructed(std::move(v));
+  TestVector<MoveThrowable> v{MoveThrowable{}};
+  TestVector<MoveThrowable> move_constructed(std::move(v));
   REQUIRE_FALSE(MoveThrowable::was_moved);
   v = std::move(move_constructed);
   REQUIRE_FALSE(MoveThrowable::was_moved);
@@ -19,16 +19,16 @@ TEST_CASE("std::move_if_noexcept") {
 
 TEST_CASE("Size Constructor", "[Safety]") {
   Throwable::until_throw = 5;
-  REQUIRE_THROWS_AS(Vector<Throwable>(10u), Exception);
+  REQUIRE_THROWS_AS(TestVector<Throwable>(10u), Exception);
 }
 
 TEST_CASE("Value Constructor", "[Safety]") {
   Throwable::until_throw = 5;
-  REQUIRE_THROWS_AS(Vector<Throwable>(10u, Throwable{}), Exception);
+  REQUIRE_THROWS_AS(TestVector<Throwable>(10u, Throwable{}), Exception);
 
   try {
     Throwable::until_throw = 15;
-    Vector<Throwable> v(10u, Throwable{});
+    TestVector<Throwable> v(10u, Throwable{});
   } catch (Exception&) {
   }
 }
@@ -37,58 +37,58 @@ TEST_CASE("Iterators Constructor", "[Safety]") {
   Throwable::until_throw = 210;
   const std::vector<Throwable> values(100u, Throwable{});
   Throwable::until_throw = 50;
-  REQUIRE_THROWS_AS(Vector<Throwable>(values.begin(), values.end()), Exception);
+  REQUIRE_THROWS_AS(TestVector<Throwable>(values.begin(), values.end()), Exception);
 
   try {
     Throwable::until_throw = 150;
-    Vector<Throwable> v(values.begin(), values.end());
+    TestVector<Throwable> v(values.begin(), values.end());
   } catch (Exception&) {
   }
 }
 
 TEST_CASE("Initializer List Constructor", "[Safety]") {
   Throwable::until_throw = 6;
-  REQUIRE_THROWS_AS(Vector<Throwable>({Throwable{}, Throwable{}, Throwable{}, Throwable{}}), Exception);
+  REQUIRE_THROWS_AS(TestVector<Throwable>({Throwable{}, Throwable{}, Throwable{}, Throwable{}}), Exception);
 
   try {
     Throwable::until_throw = 10;
-    Vector<Throwable> v({Throwable{}, Throwable{}, Throwable{}, Throwable{}});
+    TestVector<Throwable> v({Throwable{}, Throwable{}, Throwable{}, Throwable{}});
   } catch (Exception&) {
   }
 }
 
 TEST_CASE("Copy Constructor Safety", "[Safety]") {
   Throwable::until_throw = 210;
-  const Vector<Throwable> values(100u, Throwable{});
+  const TestVector<Throwable> values(100u, Throwable{});
   Throwable::until_throw = 50;
-  REQUIRE_THROWS_AS(Vector<Throwable>(values), Exception);
+  REQUIRE_THROWS_AS(TestVector<Throwable>(values), Exception);
 
   try {
     Throwable::until_throw = 150;
-    Vector<Throwable> v(values);
+    TestVector<Throwable> v(values);
   } catch (Exception&) {
   }
 }
 
 TEST_CASE("Move Constructor Safety", "[Safety]") {
   Throwable::until_throw = 210;
-  Vector<Throwable> values(100u, Throwable{});
+  TestVector<Throwable> values(100u, Throwable{});
   Throwable::until_throw = 1;
-  REQUIRE_NOTHROW(Vector<Throwable>(std::move(values)));
+  REQUIRE_NOTHROW(TestVector<Throwable>(std::move(values)));
 }
 
 TEST_CASE("Copy Assignment Safety", "[Safety]") {
   {
     Throwable::until_throw = 12;
-    const Vector<Throwable> values(5u);
+    const TestVector<Throwable> values(5u);
 
-    Vector<Throwable> v;
+    TestVector<Throwable> v;
     Throwable::until_throw = 3;
     REQUIRE_THROWS_AS(v = values, Exception);
     REQUIRE(v.Capacity() >= v.Size());
 
     try {
-      Vector<Throwable> vv;
+      TestVector<Throwable> vv;
       Throwable::until_throw = 8;
       vv = values;
     } catch (Exception&) {
@@ -97,8 +97,8 @@ TEST_CASE("Copy Assignment Safety", "[Safety]") {
 
   {
     Throwable::until_throw = 100;
-    const Vector<Throwable> values(10u);
-    Vector<Throwable> v(35u);
+    const TestVector<Throwable> values(10u);
+    TestVector<Throwable> v(35u);
     Throwable::until_throw = 5;
     REQUIRE_THROWS_AS(v = values, Exception);
     REQUIRE(v.Capacity() >= v.Size());
@@ -108,16 +108,16 @@ TEST_CASE("Copy Assignment Safety", "[Safety]") {
 TEST_CASE("Move Assignment Safety", "[Safety]") {
   {
     Throwable::until_throw = 12;
-    Vector<Throwable> values(5u);
-    Vector<Throwable> v;
+    TestVector<Throwable> values(5u);
+    TestVector<Throwable> v;
     Throwable::until_throw = 1;
     REQUIRE_NOTHROW(v = std::move(values));
   }
 
   {
     Throwable::until_throw = 100;
-    Vector<Throwable> values(10u);
-    Vector<Throwable> v(35u);
+    TestVector<Throwable> values(10u);
+    TestVector<Throwable> v(35u);
     Throwable::until_throw = 1;
     REQUIRE_NOTHROW(v = std::move(values));
   }
@@ -125,15 +125,15 @@ TEST_CASE("Move Assignment Safety", "[Safety]") {
 
 TEST_CASE("Swap Safety", "[Safety]") {
   Throwable::until_throw = 12;
-  Vector<Throwable> values(5u);
-  Vector<Throwable> v;
+  TestVector<Throwable> values(5u);
+  TestVector<Throwable> v;
   Throwable::until_throw = 1;
   REQUIRE_NOTHROW(v.Swap(values));
 }
 
 TEST_CASE("Resize Safety", "[Safety]") {
   Throwable::until_throw = 200;
-  Vector<Throwable> v(90u);
+  TestVector<Throwable> v(90u);
   const auto capacity = v.Capacity();
   const auto data = v.Data();
 
@@ -159,8 +159,9 @@ TEST_CASE("Resize Safety", "[Safety]") {
 
 TEST_CASE("Reserve Safety", "[Safety]") {
   Throwable::until_throw = 55;
-  Vector<Throwable> v(10u);
+  TestVector<Throwable> v(10u);
   REQUIRE_NOTHROW(v.Reserve(30u));
+  REQUIRE(v.Capacity() >= 30u);
 
   const auto capacity = v.Capacity();
   const auto size = v.Size();
@@ -168,6 +169,7 @@ TEST_CASE("Reserve Safety", "[Safety]") {
   try {
     Throwable::until_throw = 30;
     v.Reserve(100u);
+    REQUIRE(v.Capacity() >= 100u);
   } catch (Exception&) {
     REQUIRE(v.Capacity() == capacity);
     REQUIRE(v.Size() == size);
@@ -177,8 +179,9 @@ TEST_CASE("Reserve Safety", "[Safety]") {
 
 TEST_CASE("ShrinkToFit Safety", "[Safety]") {
   Throwable::until_throw = 95;
-  Vector<Throwable> v(20u);
+  TestVector<Throwable> v(20u);
   v.Reserve(30u);
+  REQUIRE(v.Capacity() >= 30u);
   REQUIRE_NOTHROW(v.ShrinkToFit());
 
   v.Resize(10);
@@ -197,7 +200,7 @@ TEST_CASE("ShrinkToFit Safety", "[Safety]") {
 
 TEST_CASE("PushBack Safety", "[Safety]") {
   Throwable::until_throw = 200;
-  Vector<Throwable> v;
+  TestVector<Throwable> v;
   v.Reserve(100u);
   const auto capacity = v.Capacity();
   const auto data = v.Data();
@@ -0,0 +1,89 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "simd_algorithms.hpp"
+
+const SimdLevel kLevels[] = {SimdLevel::kScalar, SimdLevel::kSse2, SimdLevel::kAvx2};
+
+// Sizes around the register widths, so that every kernel runs its tail loop too
+template <typename T>
+void CheckAgainstStd() {
+  for (size_t size = 0; size < 70; ++size) {
+    Vector<T> v(size);
+    for (size_t i = 0; i < size; ++i) {
+      v[i] = static_cast<T>((i * 37) % 11);
+    }
+    const std::vector<T> required(v.begin(), v.end());
+
+    for (SimdLevel level : kLevels) {
+      for (T value : {static_cast<T>(0), static_cast<T>(5), static_cast<T>(10), static_cast<T>(100)}) {
+        REQUIRE(simd::Find(v, value, level) == v.begin() + (std::find(required.begin(), required.end(), value) - required.begin()));
+        REQUIRE(simd::Count(v, value, level) == static_cast<size_t>(std::count(required.begin(), required.end(), value)));
+      }
+
+      REQUIRE(simd::Sum(v, level) == std::accumulate(required.begin(), required.end(), T()));
+      if (size > 0) {
+        auto min_max = std::minmax_element(required.begin(), required.end());
+        REQUIRE(simd::MinMax(v, level) == std::make_pair(*min_max.first, *min_max.second));
+      }
+
+      Vector<T> other = v;
+      REQUIRE(simd::Equal(v, other, level));
+      REQUIRE_FALSE(simd::LexicographicalCompare(v, other, level));
+      if (size > 0) {
+        other[size - 1] = static_cast<T>(other[size - 1] + 1);
+        REQUIRE_FALSE(simd::Equal(v, other, level));
+        REQUIRE(simd::LexicographicalCompare(v, other, level));
+        REQUIRE_FALSE(simd::LexicographicalCompare(other, v, level));
+        other.PopBack();
+        REQUIRE_FALSE(simd::Equal(v, other, level));
+        REQUIRE(simd::LexicographicalCompare(other, v, level));
+      }
+
+      Vector<T> filled(size);
+      simd::Fill(filled, 3, level);
+      REQUIRE(simd::Count(filled, 3, level) == size);
+    }
+  }
+}
+
+TEST_CASE("SIMD algorithms", "[SIMD]") {
+  CheckAgainstStd<int32_t>();
+  CheckAgainstStd<float>();
+  CheckAgainstStd<double>();
+  // No SIMD kernels for these, they take the scalar ones at every level
+  CheckAgainstStd<int64_t>();
+  CheckAgainstStd<uint8_t>();
+}
+
+TEST_CASE("SIMD extremes", "[SIMD]") {
+  Vector<int32_t> ints(100, 0);
+  ints[37] = std::numeric_limits<int32_t>::min();
+  ints[81] = std::numeric_limits<int32_t>::max();
+  ints[99] = std::numeric_limits<int32_t>::max();
+  for (SimdLevel level : kLevels) {
+    REQUIRE(simd::MinMax(ints, level) == std::make_pair(ints[37], ints[81]));
+    REQUIRE(simd::Find(ints, ints[81], level) == ints.begin() + 81);
+    // Integer sums wrap around
+    REQUIRE(simd::Sum(ints, level) == std::numeric_limits<int32_t>::max() - 1);
+  }
+}
+
+TEST_CASE("SIMD NaN", "[SIMD]") {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  Vector<double> a{1, 2, 3, nan, 5, 6, 7, 8, 9};
+  Vector<double> b{1, 2, 3, nan, 5, 6, 7, 8, 10};
+  for (SimdLevel level : kLevels) {
+    REQUIRE(simd::Find(a, nan, level) == a.end());
+    REQUIRE(simd::Count(a, nan, level) == 0u);
+    REQUIRE_FALSE(simd::Equal(a, a, level));
+    REQUIRE(simd::LexicographicalCompare(a, b, level));
+    REQUIRE_FALSE(simd::LexicographicalCompare(b, a, level));
+    REQUIRE(std::isnan(simd::Sum(a, level)));
+  }
+}
@@ -0,0 +1,101 @@
+#include <catch.hpp>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "test_util.hpp"
+#include "soa_vector.hpp"
+
+using Particle = Tuple<double, double, int32_t>;
+
+TEST_CASE("SoA rows and columns", "[SoA]") {
+  SoAVector<Particle> v;
+  REQUIRE(v.Empty());
+  for (int i = 0; i < 1000; ++i) {
+    v.PushBack(Particle(i * 0.5, -i * 0.5, i));
+  }
+  REQUIRE(v.Size() == 1000u);
+  REQUIRE(v.Capacity() >= 1000u);
+
+  auto row = v[10];
+  REQUIRE(get<0>(row) == 5.0);
+  REQUIRE(get<2>(row) == 10);
+
+  // The proxy writes through to the columns
+  get<1>(v[10]) = 42.0;
+  get<2>(row) = -1;
+  REQUIRE(v.Column<1>()[10] == 42.0);
+  Particle copy = v.GetRow(10);
+  REQUIRE(get<1>(copy) == 42.0);
+  REQUIRE(get<2>(copy) == -1);
+
+  auto ids = v.Column<2>();
+  REQUIRE(ids.size() == 1000u);
+  REQUIRE(std::accumulate(ids.begin(), ids.end(), int64_t{0}) == 999 * 1000 / 2 - 11);
+
+  const auto& const_v = v;
+  REQUIRE(get<0>(const_v.At(999)) == 499.5);
+  REQUIRE(const_v.Column<0>().data() == v.Column<0>().data());
+  REQUIRE_THROWS_AS(const_v.At(1000), std::out_of_range);
+
+  v.PopBack();
+  REQUIRE(v.Size() == 999u);
+  REQUIRE(v.Column<0>().size() == 999u);
+}
+
+TEST_CASE("SoA Resize and Reserve", "[SoA]") {
+  SoAVector<Tuple<int, std::string>> v(3, Tuple<int, std::string>(7, "seven"));
+  REQUIRE(get<1>(v[2]) == "seven");
+
+  v.Resize(5);
+  REQUIRE(v.Size() == 5u);
+  REQUIRE(get<0>(v[4]) == 0);
+  REQUIRE(get<1>(v[4]).empty());
+
+  v.Resize(2);
+  REQUIRE(v.Column<1>().size() == 2u);
+
+  v.Reserve(100);
+  REQUIRE(v.Capacity() >= 100u);
+  auto* data = v.Column<0>().data();
+  for (int i = 0; i < 98; ++i) {
+    v.EmplaceBack(i, "xxx");
+  }
+  REQUIRE(v.Column<0>().data() == data);
+  REQUIRE(get<1>(v[99]) == "xxx");
+
+  v.ShrinkToFit();
+  REQUIRE(v.Capacity() == 100u);
+  v.Clear();
+  REQUIRE(v.Empty());
+
+  SoAVector<Tuple<std::unique_ptr<int>, int>> pointers;
+  pointers.EmplaceBack(std::make_unique<int>(5), 1);
+  pointers.Resize(2);
+  REQUIRE(*get<0>(pointers[0]) == 5);
+  REQUIRE(get<0>(pointers[1]) == nullptr);
+}
+
+TEST_CASE("SoA keeps columns aligned on throw", "[SoA]") {
+  InstanceCounter::counter = 0;
+  Throwable::until_throw = 100;
+  {
+    const Tuple<InstanceCounter, Throwable> row;
+    SoAVector<Tuple<InstanceCounter, Throwable>> v;
+    v.PushBack(row);
+
+    Throwable::until_throw = 1;
+    REQUIRE_THROWS_AS(v.PushBack(row), Exception);
+    REQUIRE(v.Size() == 1u);
+    REQUIRE(v.Column<0>().size() == 1u);
+    REQUIRE(v.Column<1>().size() == 1u);
+
+    Throwable::until_throw = 5;
+    REQUIRE_THROWS_AS(v.Resize(10, row), Exception);
+    REQUIRE(v.Column<0>().size() == 1u);
+    REQUIRE(InstanceCounter::counter == 2);
+  }
+  REQUIRE(InstanceCounter::counter == 0);
+}
@@ -2,13 +2,51 @@
 
 #include <stdexcept>
 #include <exception>
-
+#include <memory>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <initializer_list>
+#include <type_traits>
+
+#include "growth_policy.hpp"
+
+// Types whose objects may be moved to another address with memcpy, leaving the source
+// as raw memory. Specialize for types that own resources but don't point into themselves.
 template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+// Allocators may provide reallocate(ptr, old_count, new_count) that resizes a block
+// keeping its bytes, like realloc does
+template <typename Alloc, typename = void>
+struct HasReallocate : std::false_type {};
+
+template <typename Alloc>
+struct HasReallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<typename std::allocator_traits<Alloc>::pointer>(), size_t(), size_t()))>> : std::true_type {};
+
+template <typename Growth, typename = void>
+struct HasReallocationHook : std::false_type {};
+
+template <typename Growth>
+struct HasReallocationHook<Growth, std::void_t<decltype(std::declval<Growth&>().OnReallocation(
+    size_t(), size_t(), size_t()))>> : std::true_type {};
+
+// Defined in parallel_vector.hpp, which adds the opt-in parallel construction,
+// Resize and Fill on top of the internals below
+struct ParallelVectorAccess;
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = DoublingGrowth>
 class Vector {
 
+friend struct ParallelVectorAccess;
+
 public:
 
 using ValueType = T;
+using AllocatorType = Alloc;
+using GrowthPolicy = Growth;
 using Pointer = T*;
 using ConstPointer = const T*;
 using Reference = T&;
@@ -19,25 +57,28 @@ using ConstIterator = const T*;
 using ReverseIterator = std::reverse_iterator<Iterator>;
 using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
 
-    
+using AllocTraits = std::allocator_traits<Alloc>;
+
+
 //------------------------------constructors------------------------------
 
-    Vector() : data_(nullptr), size_(0), capacity_(0) {}
+    Vector() : Vector(Alloc()) {}
+
+    explicit Vector(const Alloc& alloc) : data_(nullptr), size_(0), capacity_(0), alloc_(alloc) {}
 
-    Vector(size_t size) 
-        : size_(size), capacity_(size) 
+    Vector(size_t size, const Alloc& alloc = Alloc())
+        : size_(size), capacity_(size), alloc_(alloc)
     {
         if (size > 0) {
             size_t idx = 0;
+            data_ = Allocate(size);
             try {
-                data_ = reinterpret_cast<T*>(new int8_t[size * sizeof(T)]);
                 for (idx = 0; idx < size; ++idx)
-                    new (data_ + idx) T();
+                    AllocTraits::construct(alloc_, data_ + idx);
             }
             catch (...) {
-                for (size_t i = 0; i < idx; ++i)
-                    (data_ + i)->~T();
-                delete[] reinterpret_cast<int8_t*>(data_);
+                DestroyRange(data_, data_ + idx);
+                Deallocate(data_, size);
                 data_ = nullptr;
 
                 throw;
@@ -45,20 +86,19 @@ using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
         }
     }
 
-    Vector(size_t size, const T& elem)
-        : size_(size), capacity_(size)
+    Vector(size_t size, const T& elem, const Alloc& alloc = Alloc())
+        : size_(size), capacity_(size), alloc_(alloc)
     {
         if (size > 0) {
             size_t idx = 0;
+            data_ = Allocate(size);
             try {
-                data_ = reinterpret_cast<T*>(new int8_t[size * sizeof(T)]);
                 for (idx = 0; idx < size; ++idx)
-                    new (data_ + idx) T(elem);
+                    AllocTraits::construct(alloc_, data_ + idx, elem);
             }
             catch (...) {
-                for (size_t i = 0; i < idx; ++i)
-                    (data_ + i)->~T();
-                delete[] reinterpret_cast<int8_t*>(data_);
+                DestroyRange(data_, data_ + idx);
+                Deallocate(data_, size);
                 data_ = nullptr;
 
                 throw;
@@ -66,21 +106,20 @@ using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
         }
     }
 
-    Vector(const std::initializer_list<T>& list) {
-        int size = list.size();
+    Vector(const std::initializer_list<T>& list, const Alloc& alloc = Alloc()) : alloc_(alloc) {
+        size_t size = list.size();
         size_ = size;
         capacity_ = size;
         if (size > 0) {
             size_t idx = 0;
+            data_ = Allocate(size);
             try {
-                data_ = reinterpret_cast<T*>(new int8_t[size * sizeof(T)]);
                 for (auto it = list.begin(); it != list.end(); ++it, ++idx)
-                    new (data_ + idx) T(*it);
+                    AllocTraits::construct(alloc_, data_ + idx, *it);
             }
             catch (...) {
-                for (size_t i = 0; i < idx; ++i)
-                    (data_ + i)->~T();
-                delete[] reinterpret_cast<int8_t*>(data_);
+                DestroyRange(data_, data_ + idx);
+                Deallocate(data_, size);
                 data_ = nullptr;
 
                 throw;
@@ -88,35 +127,43 @@ using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
         }
     }
 
-    Vector(const Vector& other) 
-        : size_(other.size_), capacity_(other.capacity_)
+    Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.alloc_)) {}
+
+    Vector(const Vector& other, const Alloc& alloc)
+        : size_(other.size_), capacity_(other.capacity_), alloc_(alloc)
     {
-        if (other.data_ != nullptr) {
+        if (other.data_ == nullptr)
+            return;
+
+        data_ = Allocate(other.capacity_);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (other.size_ > 0)
+                std::memcpy(static_cast<void*>(data_), static_cast<const void*>(other.data_), other.size_ * sizeof(T));
+        } else {
             size_t idx = 0;
             try {
-                data_ = reinterpret_cast<T*>(new int8_t[other.capacity_ * sizeof(T)]);
                 for (idx = 0; idx < other.size_; ++idx) {
-                    new (data_ + idx) T(other.data_[idx]);
+                    AllocTraits::construct(alloc_, data_ + idx, other.data_[idx]);
                 }
             }
             catch (...) {
-                for (size_t i = 0; i < idx; ++i)
-                    (data_ + i)->~T();
-                delete[] reinterpret_cast<int8_t*>(data_);
+                DestroyRange(data_, data_ + idx);
+                Deallocate(data_, other.capacity_);
                 data_ = nullptr;
 
                 throw;
             }
-        } 
+        }
     }
 
-    Vector(Vector&& other) noexcept {
-        Swap(other);
+    Vector(Vector&& other) noexcept : alloc_(std::move(other.alloc_)) {
+        StealBuffer(other);
     }
 
     template<typename InputIterator,
     typename = typename std::iterator_traits<InputIterator>::iterator_category>
-    Vector(InputIterator begin, InputIterator end) {
+    Vector(InputIterator begin, InputIterator end, const Alloc& alloc = Alloc()) : alloc_(alloc) {
         if (begin != end) {
             try {
                 while (begin != end) {
@@ -127,9 +174,8 @@ using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
                 ShrinkToFit();
             }
             catch(...) {
-                for (size_t i = 0; i < size_; ++i)
-                    (data_ + i)->~T();
-                delete[] reinterpret_cast<int8_t*>(data_);
+                DestroyRange(data_, data_ + size_);
+                Deallocate(data_, capacity_);
                 data_ = nullptr;
 
                 throw;
@@ -140,13 +186,8 @@ using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
 //-----------------------------destructor--------------------------------
 
     ~Vector() {
-        if (data_ != nullptr) {
-            for (size_t i = 0; i < size_; ++i) {
-                (data_ + i)->~T();
-            }
-        }
-
-        delete[] reinterpret_cast<int8_t*>(data_);
+        DestroyRange(data_, data_ + size_);
+        Deallocate(data_, capacity_);
     }
 
 //-----------------------------iterators--------------------------------
@@ -205,25 +246,41 @@ using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
         if (this == &other)
             return *this;
 
-        Vector temp = other;
-        Swap(temp);
+        Vector temp(other, AllocTraits::propagate_on_container_copy_assignment::value ? other.alloc_ : alloc_);
+        SwapWithAllocator(temp);
 
         return *this;
     }
 
-    Vector& operator=(Vector&& other) noexcept {
+    Vector& operator=(Vector&& other) noexcept(AllocTraits::propagate_on_container_move_assignment::value ||
+                                               AllocTraits::is_always_equal::value) {
         if (this == &other)
             return *this;
 
-        for (size_t i = 0; i < size_; ++i) {
-            (data_ + i)->~T();
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value &&
+                      !AllocTraits::is_always_equal::value) {
+            if (!(alloc_ == other.alloc_)) {
+                // Foreign storage can't be adopted, so the elements are moved one by one
+                Vector temp(alloc_);
+                temp.Reserve(other.size_);
+                for (size_t i = 0; i < other.size_; ++i)
+                    temp.PushBack(std::move(other.data_[i]));
+
+                SwapWithAllocator(temp);
+                return *this;
+            }
         }
-        delete[] reinterpret_cast<int8_t*>(data_);
+
+        DestroyRange(data_, data_ + size_);
+        Deallocate(data_, capacity_);
         data_ = nullptr;
         size_ = 0;
         capacity_ = 0;
 
-        Swap(other);
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            alloc_ = std::move(other.alloc_);
+        }
+        StealBuffer(other);
 
         return *this;
     }
@@ -239,14 +296,27 @@ using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
 //-----------------------------methods----------------------------------
 
     void Swap(Vector& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        }
         std::swap(data_, other.data_);
         std::swap(size_, other.size_);
         std::swap(capacity_, other.capacity_);
     }
 
+    Alloc GetAllocator() const {
+        return alloc_;
+    }
+
+    // The policy object lives as long as the vector itself: copies, moves and swaps
+    // transfer elements but not the reallocation history of a counting policy
+    const Growth& GetGrowthPolicy() const {
+        return growth_;
+    }
+
     T* Data() {
         return data_;
-    }    
+    }
 
     const T* Data() const {
         return data_;
@@ -293,184 +363,485 @@ using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
     }
 
     void Clear() {
-        for (size_t i = 0; i < size_; ++i) {
-            (data_ + i)->~T();
-        }
+        DestroyRange(data_, data_ + size_);
         size_ = 0;
     }
 
     void Resize(size_t size) {
         if (size <= size_) {
-            for (size_t i = size; i < size_; ++i) {
-                (data_ + i)->~T();
-            }
+            DestroyRange(data_ + size, data_ + size_);
             size_ = size;
 
             return;
         }
 
-        T* new_data_ = reinterpret_cast<T*>(new int8_t[size * sizeof(T)]);
-        size_t idx = 0;
-        try {
-            for (idx = 0; idx < size - size_; ++idx) {
-                new (new_data_ + idx) T();
-            }
-        }
-        catch (...) {
-            for (size_t i = 0; i < idx; ++i)
-                (new_data_ + i)->~T();
-            delete[] reinterpret_cast<int8_t*>(new_data_);
-                
-            throw;
-        }
+        size_t count = size - size_;
+        AppendExact(count, [this, count](T* place) { ConstructDefault(place, count); });
+    }
 
-        if (size > capacity_) {
-            Reserve(size);
-        }
-        try {
-            for (idx = size_; idx < size; ++idx) {
-                new (data_ + idx) T();
-            }
-        }
-        catch (...) {
-                for (size_t i = size_; i < idx; ++i)
-                    (data_ + i)->~T();
-                for (size_t i = 0; i < size - size_; ++i) {
-                    (new_data_ + i)->~T();
-                }
-                delete[] reinterpret_cast<int8_t*>(new_data_);
-                throw;
+    void Resize(size_t size, const T& elem) {
+        if (size <= size_) {
+            DestroyRange(data_ + size, data_ + size_);
+            size_ = size;
+
+            return;
         }
 
-        for (size_t i = 0; i < size - size_; ++i)   
-            (new_data_ + i)->~T();
+        // elem may live in this vector, the new elements are built before relocation
+        size_t count = size - size_;
+        AppendExact(count, [this, count, &elem](T* place) { ConstructFill(place, count, elem); });
+    }
+
+    // Grows the vector without initializing the new elements, e.g. to read() into them:
+    // a Vector<uint8_t> resized this way isn't zeroed first. Only for trivial T,
+    // whose objects are just bytes that have to be written before being read.
+    void ResizeUninitialized(size_t size) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "ResizeUninitialized needs a trivial element type");
 
-        delete[] reinterpret_cast<int8_t*>(new_data_);
+        if (size > capacity_)
+            Reallocate(size);
         size_ = size;
     }
 
-    void Resize(size_t size, const T& elem) {
-        if (size <= size_) {
-            for (size_t i = size; i < size_; ++i) {
-                (data_ + i)->~T();
-            }
-            size_ = size;
+    // Assigns elem to every element
+    void Fill(const T& elem) {
+        std::fill(data_, data_ + size_, elem);
+    }
 
+    void Reserve(size_t capacity) {
+        if (capacity_ >= capacity)
             return;
-        }
 
-        T* new_data_ = reinterpret_cast<T*>(new int8_t[size * sizeof(T)]);
-        size_t idx = 0;
-        try {
-            for (idx = 0; idx < size - size_; ++idx) {
-                new (new_data_ + idx) T(std::move_if_noexcept(elem));
+        Reallocate(capacity);
+    }
+
+    void ShrinkToFit() {
+        if (capacity_ == size_)
+            return;
+
+        Reallocate(size_);
+    }
+
+    template<typename... Args>
+    void EmplaceBack(Args&&... args) {
+        if (size_ == capacity_) {
+            if constexpr (IsTriviallyRelocatable<T>::value && HasReallocate<Alloc>::value) {
+                if (data_ != nullptr) {
+                    GrowByReallocate(std::forward<Args>(args)...);
+                    return;
+                }
             }
+            // args may refer to an element of this vector, so the new element is built before relocation
+            InsertReallocating(size_, 1, [&](T* place) {
+                AllocTraits::construct(alloc_, place, std::forward<Args>(args)...);
+            });
+            return;
         }
-        catch (...) {
-            for (size_t i = 0; i < idx; ++i)
-                (new_data_ + i)->~T();
-            delete[] reinterpret_cast<int8_t*>(new_data_);
-                
-            throw;
+
+        AllocTraits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+        size_++;
+    }
+
+    void PushBack(const T& elem) {
+        EmplaceBack(elem);
+    }
+
+    void PushBack(T&& elem) {
+        EmplaceBack(std::move(elem));
+    }
+
+    void PopBack() {
+        if (size_ > 0) {
+            AllocTraits::destroy(alloc_, data_ + size_ - 1);
+            size_--;
         }
+    }
 
-        if (size > capacity_) {
-            Reserve(size);
+    template<typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        size_t idx = static_cast<size_t>(pos - data_);
+        if (idx == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return data_ + idx;
         }
-        try {
-            for (idx = size_; idx < size; ++idx) {
-                new (data_ + idx) T(std::move_if_noexcept(new_data_[idx-size_]));
+
+        if (size_ == capacity_) {
+            InsertReallocating(idx, 1, [&](T* place) {
+                AllocTraits::construct(alloc_, place, std::forward<Args>(args)...);
+            });
+            return data_ + idx;
+        }
+
+        T elem(std::forward<Args>(args)...);
+        AllocTraits::construct(alloc_, data_ + size_, std::move(data_[size_ - 1]));
+        size_++;
+        std::move_backward(data_ + idx, data_ + size_ - 2, data_ + size_ - 1);
+        data_[idx] = std::move(elem);
+
+        return data_ + idx;
+    }
+
+    Iterator Insert(ConstIterator pos, const T& elem) {
+        return Emplace(pos, elem);
+    }
+
+    Iterator Insert(ConstIterator pos, T&& elem) {
+        return Emplace(pos, std::move(elem));
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC 12 can't relate capacity_ to the size of a buffer it saw allocated, so it
+// flags the shifts below on in-place paths that only run when the buffer is big enough
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#pragma GCC diagnostic ignored "-Wstringop-overread"
+#endif
+
+    Iterator Insert(ConstIterator pos, size_t count, const T& elem) {
+        size_t idx = static_cast<size_t>(pos - data_);
+        if (count == 0)
+            return data_ + idx;
+
+        if (size_ + count > capacity_) {
+            InsertReallocating(idx, count, [&](T* place) {
+                ConstructFill(place, count, elem);
+            });
+            return data_ + idx;
+        }
+
+        // elem may live in the shifted part of the vector
+        T copy(elem);
+        T* position = data_ + idx;
+        size_t elems_after = size_ - idx;
+        if (elems_after > count) {
+            MoveToUninitialized(data_ + size_ - count, data_ + size_, data_ + size_);
+            size_ += count;
+            std::move_backward(position, position + elems_after - count, position + elems_after);
+            std::fill_n(position, count, copy);
+        } else {
+            ConstructFill(data_ + size_, count - elems_after, copy);
+            size_t old_size = size_;
+            size_ += count - elems_after;
+            MoveToUninitialized(position, data_ + old_size, data_ + size_);
+            size_ += elems_after;
+            std::fill_n(position, elems_after, copy);
+        }
+
+        return position;
+    }
+
+    template<typename InputIterator,
+    typename = typename std::iterator_traits<InputIterator>::iterator_category>
+    Iterator Insert(ConstIterator pos, InputIterator first, InputIterator last) {
+        size_t idx = static_cast<size_t>(pos - data_);
+        if constexpr (!std::is_base_of_v<std::forward_iterator_tag,
+                      typename std::iterator_traits<InputIterator>::iterator_category>) {
+            // Single pass ranges can't be measured beforehand, so they are buffered first
+            Vector buffer(first, last, alloc_);
+            return Insert(pos, std::make_move_iterator(buffer.begin()), std::make_move_iterator(buffer.end()));
+        } else {
+            size_t count = static_cast<size_t>(std::distance(first, last));
+            if (count == 0)
+                return data_ + idx;
+
+            if (size_ + count > capacity_) {
+                InsertReallocating(idx, count, [&](T* place) {
+                    ConstructRange(place, first, count);
+                });
+                return data_ + idx;
+            }
+
+            T* position = data_ + idx;
+            size_t elems_after = size_ - idx;
+            if (elems_after > count) {
+                MoveToUninitialized(data_ + size_ - count, data_ + size_, data_ + size_);
+                size_ += count;
+                std::move_backward(position, position + elems_after - count, position + elems_after);
+                std::copy(first, last, position);
+            } else {
+                InputIterator middle = first;
+                std::advance(middle, elems_after);
+                ConstructRange(data_ + size_, middle, count - elems_after);
+                size_t old_size = size_;
+                size_ += count - elems_after;
+                MoveToUninitialized(position, data_ + old_size, data_ + size_);
+                size_ += elems_after;
+                std::copy(first, middle, position);
             }
+
+            return position;
         }
-        catch (...) {
-                for (size_t i = size_; i < idx; ++i)
-                    (data_ + i)->~T();
-                for (size_t i = 0; i < size - size_; ++i) {
-                    (new_data_ + i)->~T();
-                }
-                delete[] reinterpret_cast<int8_t*>(new_data_);
-                throw;
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    Iterator Insert(ConstIterator pos, std::initializer_list<T> list) {
+        return Insert(pos, list.begin(), list.end());
+    }
+
+    template<typename InputIterator,
+    typename = typename std::iterator_traits<InputIterator>::iterator_category>
+    void AppendRange(InputIterator first, InputIterator last) {
+        Insert(cend(), first, last);
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        T* position = data_ + (first - data_);
+        if (first != last) {
+            T* new_end = std::move(position + (last - first), data_ + size_, position);
+            DestroyRange(new_end, data_ + size_);
+            size_ = static_cast<size_t>(new_end - data_);
         }
 
-        for (size_t i = 0; i < size - size_; ++i)   
-            (new_data_ + i)->~T();
+        return position;
+    }
 
-        delete[] reinterpret_cast<int8_t*>(new_data_);
-        size_ = size;
+private:
+    T* Allocate(size_t count) {
+        if (count == 0)
+            return nullptr;
+        return AllocTraits::allocate(alloc_, count);
     }
 
-    void Reserve(size_t capacity) {
-        if (capacity_ >= capacity)
-            return;
+    void Deallocate(T* data, size_t count) {
+        if (data != nullptr)
+            AllocTraits::deallocate(alloc_, data, count);
+    }
 
-        T* new_data_ = reinterpret_cast<T*>(new int8_t[capacity * sizeof(T)]);
-        size_t idx = 0;
+    void DestroyRange(T* begin, T* end) {
+        for (; begin != end; ++begin)
+            AllocTraits::destroy(alloc_, begin);
+    }
 
-        for (idx = 0; idx < size_; ++idx) {
+    size_t GrowthCapacity(size_t required) const {
+        return std::max(required, Growth::NextCapacity(capacity_, required, sizeof(T)));
+    }
+
+    void NotifyReallocation(size_t old_capacity, size_t new_capacity, size_t bytes_moved) {
+        if constexpr (HasReallocationHook<Growth>::value) {
+            growth_.OnReallocation(old_capacity, new_capacity, bytes_moved);
+        }
+    }
+
+#if defined(__GNUC__) && !defined(__clang__)
+// Same false positives as around Insert, for copies into a buffer of capacity_
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#pragma GCC diagnostic ignored "-Wstringop-overflow"
+#pragma GCC diagnostic ignored "-Wstringop-overread"
+#endif
+
+    // Moves [begin, end) into raw memory at dest. If a copy throws, whatever was built
+    // at dest is destroyed and the source stays intact.
+    void MoveToUninitialized(T* begin, T* end, T* dest) {
+        if constexpr (IsTriviallyRelocatable<T>::value && std::is_trivially_copyable_v<T>) {
+            if (begin < end)
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(begin), static_cast<size_t>(end - begin) * sizeof(T));
+        } else {
+            T* cur = dest;
             try {
-                new (new_data_ + idx) T(std::move_if_noexcept(data_[idx]));
+                for (; begin != end; ++begin, ++cur)
+                    AllocTraits::construct(alloc_, cur, std::move_if_noexcept(*begin));
             }
             catch (...) {
-                for (size_t i = 0; i < idx; ++i) {
-                    (new_data_ + i)->~T();
-                }
-                delete[] reinterpret_cast<int8_t*>(new_data_);
-                new_data_ = nullptr;
+                DestroyRange(dest, cur);
                 throw;
             }
-        }    
+        }
+    }
 
-        for (size_t i = 0; i < size_; ++i) 
-            (data_ + i)->~T();
-        
-        delete[] reinterpret_cast<int8_t*>(data_);
-        data_ = new_data_;
-        capacity_ = capacity;
+    // Relocation to another buffer: either bitwise, leaving the source as raw memory,
+    // or by MoveToUninitialized, after which FinishRelocation destroys the source
+    void RelocateToUninitialized(T* begin, T* end, T* dest) {
+        if constexpr (IsTriviallyRelocatable<T>::value) {
+            if (begin < end)
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(begin), static_cast<size_t>(end - begin) * sizeof(T));
+        } else {
+            MoveToUninitialized(begin, end, dest);
+        }
     }
 
-    void ShrinkToFit() {
-        Vector new_v(size_);
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    void FinishRelocation(T* begin, T* end) {
+        if constexpr (!IsTriviallyRelocatable<T>::value) {
+            DestroyRange(begin, end);
+        }
+    }
+
+    void ConstructFill(T* dest, size_t count, const T& elem) {
         size_t idx = 0;
         try {
-            for (idx = 0; idx < size_; ++idx)
-                new_v[idx] = std::move_if_noexcept(data_[idx]);
+            for (; idx < count; ++idx)
+                AllocTraits::construct(alloc_, dest + idx, elem);
         }
         catch (...) {
-            for (size_t i = 0; i < idx; ++i) {
-                new_v.PopBack();
-            }
+            DestroyRange(dest, dest + idx);
+            throw;
         }
+    }
 
-        Swap(new_v);
+    void ConstructDefault(T* dest, size_t count) {
+        size_t idx = 0;
+        try {
+            for (; idx < count; ++idx)
+                AllocTraits::construct(alloc_, dest + idx);
+        }
+        catch (...) {
+            DestroyRange(dest, dest + idx);
+            throw;
+        }
     }
 
-    template<typename... Args>
-    void EmplaceBack(Args... args) {
-        if (size_ == capacity_) {
-            Reserve(std::max(static_cast<size_t>(1), capacity_ * 2));
+    template <typename ForwardIterator>
+    void ConstructRange(T* dest, ForwardIterator first, size_t count) {
+        size_t idx = 0;
+        try {
+            for (; idx < count; ++idx, ++first)
+                AllocTraits::construct(alloc_, dest + idx, *first);
         }
+        catch (...) {
+            DestroyRange(dest, dest + idx);
+            throw;
+        }
+    }
 
-        new (data_ + size_) T(std::forward<Args>(args)...);
-        size_++;
+    // Builds count new elements at position idx of a new buffer with construct(place),
+    // then relocates the old elements around them. Any failure leaves the vector intact.
+    template <typename Construct>
+    void InsertReallocating(size_t idx, size_t count, Construct&& construct) {
+        InsertReallocating(idx, count, GrowthCapacity(size_ + count), construct);
     }
 
-    void PushBack(const T& elem) {
-        EmplaceBack(elem);
+    template <typename Construct>
+    void InsertReallocating(size_t idx, size_t count, size_t new_capacity, Construct&& construct) {
+        T* new_data_ = Allocate(new_capacity);
+        try {
+            construct(new_data_ + idx);
+        }
+        catch (...) {
+            Deallocate(new_data_, new_capacity);
+            throw;
+        }
+
+        try {
+            RelocateToUninitialized(data_, data_ + idx, new_data_);
+        }
+        catch (...) {
+            DestroyRange(new_data_ + idx, new_data_ + idx + count);
+            Deallocate(new_data_, new_capacity);
+            throw;
+        }
+
+        try {
+            RelocateToUninitialized(data_ + idx, data_ + size_, new_data_ + idx + count);
+        }
+        catch (...) {
+            DestroyRange(new_data_, new_data_ + idx + count);
+            Deallocate(new_data_, new_capacity);
+            throw;
+        }
+
+        FinishRelocation(data_, data_ + size_);
+        Deallocate(data_, capacity_);
+        NotifyReallocation(capacity_, new_capacity, size_ * sizeof(T));
+        data_ = new_data_;
+        size_ += count;
+        capacity_ = new_capacity;
     }
 
-    void PushBack(T&& elem) {
-        EmplaceBack(std::forward<T>(elem));
+    // Constructs count elements at the end with construct(place), in place when they
+    // fit and otherwise in a buffer of exactly the new size, like Reserve would take
+    template <typename Construct>
+    void AppendExact(size_t count, Construct&& construct) {
+        if (size_ + count > capacity_) {
+            InsertReallocating(size_, count, size_ + count, construct);
+            return;
+        }
+
+        construct(data_ + size_);
+        size_ += count;
+    }
+
+    // True if one of args lives in the buffer, e.g. an element or a member of one
+    template <typename... Args>
+    bool InBuffer(const Args&... args) const {
+        std::less_equal<const void*> less_equal;
+        std::less<const void*> less;
+        return ((less_equal(data_, std::addressof(args)) && less(std::addressof(args), data_ + capacity_)) || ...);
+    }
+
+    // EmplaceBack into a full buffer that the allocator can resize in place. The new
+    // element goes through a temporary only if args may move along with the buffer.
+    template <typename... Args>
+    void GrowByReallocate(Args&&... args) {
+        if (InBuffer(args...)) {
+            T elem(std::forward<Args>(args)...);
+            Reallocate(GrowthCapacity(size_ + 1));
+            AllocTraits::construct(alloc_, data_ + size_, std::move(elem));
+        } else {
+            Reallocate(GrowthCapacity(size_ + 1));
+            AllocTraits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
+        }
+        size_++;
     }
 
-    void PopBack() {
-        if (size_ > 0) {
-            (data_ + size_ - 1)->~T();
-            size_--;
+    void Reallocate(size_t capacity) {
+        if constexpr (IsTriviallyRelocatable<T>::value && HasReallocate<Alloc>::value) {
+            if (data_ != nullptr && capacity > 0) {
+                T* new_data_ = alloc_.reallocate(data_, capacity_, capacity);
+                NotifyReallocation(capacity_, capacity, new_data_ == data_ ? 0 : size_ * sizeof(T));
+                data_ = new_data_;
+                capacity_ = capacity;
+                return;
+            }
         }
+
+        T* new_data_ = Allocate(capacity);
+        try {
+            RelocateToUninitialized(data_, data_ + size_, new_data_);
+        }
+        catch (...) {
+            Deallocate(new_data_, capacity);
+            throw;
+        }
+
+        FinishRelocation(data_, data_ + size_);
+        Deallocate(data_, capacity_);
+        NotifyReallocation(capacity_, capacity, size_ * sizeof(T));
+        data_ = new_data_;
+        capacity_ = capacity;
+    }
+
+    void StealBuffer(Vector& other) noexcept {
+        data_ = other.data_;
+        size_ = other.size_;
+        capacity_ = other.capacity_;
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+
+    void SwapWithAllocator(Vector& other) noexcept {
+        std::swap(alloc_, other.alloc_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
     }
 
-private:
     T* data_ = nullptr;
     size_t size_ = 0;
     size_t capacity_ = 0;
+    [[no_unique_address]] Alloc alloc_;
+    [[no_unique_address]] Growth growth_;
 };